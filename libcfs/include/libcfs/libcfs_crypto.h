@@ -302,6 +302,7 @@ int cfs_crypto_hash_digest(enum cfs_crypto_hash_alg hash_alg,
 
 /* cfs crypto hash descriptor */
 struct page;
+struct scatterlist;
 
 struct ahash_request *
 	cfs_crypto_hash_init(enum cfs_crypto_hash_alg hash_alg,
@@ -311,6 +312,8 @@ int cfs_crypto_hash_update_page(struct ahash_request *req,
 				unsigned int len);
 int cfs_crypto_hash_update(struct ahash_request *req, const void *buf,
 			   unsigned int buf_len);
+int cfs_crypto_hash_update_sg(struct ahash_request *req,
+			      struct scatterlist *sg, unsigned int len);
 int cfs_crypto_hash_final(struct ahash_request *req,
 			  unsigned char *hash, unsigned int *hash_len);
 int cfs_crypto_register(void);
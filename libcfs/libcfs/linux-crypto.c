@@ -274,6 +274,28 @@ int cfs_crypto_hash_update(struct ahash_request *req,
 }
 EXPORT_SYMBOL(cfs_crypto_hash_update);
 
+/**
+ * Update hash digest computed on the data of a scatterlist
+ *
+ * Hashing several page fragments with one update saves the per-update setup
+ * of the hash walk, compared to calling cfs_crypto_hash_update_page() for
+ * each of them.
+ *
+ * \param[in] req	ahash request
+ * \param[in] sg	scatterlist of the data, with its end marked
+ * \param[in] len	length of data in \a sg on which to compute hash
+ *
+ * \retval		0 for success
+ * \retval		negative errno on failure
+ */
+int cfs_crypto_hash_update_sg(struct ahash_request *req,
+			      struct scatterlist *sg, unsigned int len)
+{
+	ahash_request_set_crypt(req, sg, NULL, len);
+	return crypto_ahash_update(req);
+}
+EXPORT_SYMBOL(cfs_crypto_hash_update_sg);
+
 /**
  * Finish hash calculation, copy hash digest to buffer, clean up hash descriptor
  *
@@ -2457,6 +2457,29 @@ AC_DEFUN([LC_BIO_INTEGRITY_ENABLED], [
 	])
 ]) # LC_BIO_INTEGRITY_ENABLED
 
+#
+# LC_HAVE_FILEMAP_RANGE_HAS_PAGE
+#
+# 4.13 introduced filemap_range_has_page()
+#
+AC_DEFUN([LC_SRC_HAVE_FILEMAP_RANGE_HAS_PAGE], [
+	LB2_LINUX_TEST_SRC([filemap_range_has_page], [
+		#include <linux/fs.h>
+	],[
+		bool ret;
+
+		ret = filemap_range_has_page(NULL, 0, 0);
+		(void)ret;
+	])
+])
+AC_DEFUN([LC_HAVE_FILEMAP_RANGE_HAS_PAGE], [
+	AC_MSG_CHECKING([if 'filemap_range_has_page' exist])
+	LB2_LINUX_TEST_RESULT([filemap_range_has_page], [
+		AC_DEFINE(HAVE_FILEMAP_RANGE_HAS_PAGE, 1,
+			['filemap_range_has_page' is available])
+	])
+]) # LC_HAVE_FILEMAP_RANGE_HAS_PAGE
+
 #
 # LC_PAGEVEC_INIT_ONE_PARAM
 #
@@ -2969,6 +2992,31 @@ AC_DEFUN([LC_HAVE_USER_NAMESPACE_ARG], [
 	])
 ]) # LC_HAVE_USER_NAMESPACE_ARG
 
+#
+# LC_HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
+#
+# kernel 5.12 commit f9ce0be71d1fbb038ada15ced83474b0e63f264d
+# mm: Cleanup faultaround and finish_fault() codepaths
+# vm_operations_struct::map_pages() returns vm_fault_t instead of void.
+#
+AC_DEFUN([LC_SRC_HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T], [
+	LB2_LINUX_TEST_SRC([vm_ops_map_pages_vm_fault_t], [
+		#include <linux/mm.h>
+	],[
+		vm_fault_t ret;
+
+		ret = ((struct vm_operations_struct *)1)->map_pages(NULL, 0, 0);
+		(void)ret;
+	],[-Werror])
+])
+AC_DEFUN([LC_HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T], [
+	AC_MSG_CHECKING([if 'vm_operations_struct.map_pages' returns vm_fault_t])
+	LB2_LINUX_TEST_RESULT([vm_ops_map_pages_vm_fault_t], [
+		AC_DEFINE(HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T, 1,
+			['vm_operations_struct.map_pages' returns vm_fault_t])
+	])
+]) # LC_HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
+
 #
 # LC_HAVE_GET_ACL_RCU_ARG
 #
@@ -3788,6 +3836,7 @@ AC_DEFUN([LC_PROG_LINUX_SRC], [
 	LC_SRC_BIO_INTEGRITY_ENABLED
 	LC_SRC_BIO_INTEGRITY_PREP_FN_RETURNS_BOOL
 	LC_SRC_HAVE_GET_INODE_USAGE
+	LC_SRC_HAVE_FILEMAP_RANGE_HAS_PAGE
 
 	# 4.14
 	LC_SRC_PAGEVEC_INIT_ONE_PARAM
@@ -3832,6 +3881,7 @@ AC_DEFUN([LC_PROG_LINUX_SRC], [
 
 	# 5.12
 	LC_SRC_HAVE_USER_NAMESPACE_ARG
+	LC_SRC_HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
 
 	# 5.15
 	LC_SRC_HAVE_GET_ACL_RCU_ARG
@@ -4039,6 +4089,7 @@ AC_DEFUN([LC_PROG_LINUX_RESULTS], [
 	LC_BIO_INTEGRITY_ENABLED
 	LC_BIO_INTEGRITY_PREP_FN_RETURNS_BOOL
 	LC_HAVE_GET_INODE_USAGE
+	LC_HAVE_FILEMAP_RANGE_HAS_PAGE
 
 	# 4.14
 	LC_PAGEVEC_INIT_ONE_PARAM
@@ -4083,6 +4134,7 @@ AC_DEFUN([LC_PROG_LINUX_RESULTS], [
 
 	# 5.12
 	LC_HAVE_USER_NAMESPACE_ARG
+	LC_HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
 
         # 5.15
         LC_HAVE_GET_ACL_RCU_ARG
@@ -2000,7 +2000,12 @@ struct cl_io {
 	 * to userspace, only the RPCs are submitted async, then waited for at
 	 * the llite layer before returning.
 	 */
-			     ci_parallel_dio:1;
+			     ci_parallel_dio:1,
+	/**
+	 * Buffered I/O that llite switched to the DIO path (hybrid I/O), it
+	 * behaves as O_DIRECT without the file being opened that way.
+	 */
+			     ci_hybrid_switched:1;
 	/**
 	 * Bypass quota check
 	 */
@@ -2067,6 +2072,18 @@ struct cache_stats {
 /** These are not exported so far */
 void cache_stats_init (struct cache_stats *cs, const char *name);
 
+/**
+ * Stages of an iteration of cl_io_loop(), whose latency is tracked in
+ * cl_site::cs_io_hist.
+ */
+enum cl_io_stage {
+	CL_IO_STAGE_ITER_INIT = 0,
+	CL_IO_STAGE_LOCK,
+	CL_IO_STAGE_START,
+	CL_IO_STAGE_END,
+	CL_IO_STAGE_NR
+};
+
 /**
  * Client-side site. This represents particular client stack. "Global"
  * variables should (directly or indirectly) be added here to allow multiple
@@ -2085,6 +2102,21 @@ struct cl_site {
 	 */
 	struct cache_stats	cs_pages;
 	atomic_t		cs_pages_state[CPS_NR];
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	/**
+	 * Number of cl_pages and the memory they use, including the slices
+	 * of all layers, exported in the site file as the metadata cost per
+	 * GiB of cached data.
+	 */
+	struct percpu_counter	cs_page_count;
+	struct percpu_counter	cs_page_bytes;
+#endif
+	/**
+	 * log2 histograms of the time in usec that reads and writes spend in
+	 * each cl_io_loop() stage, exported as
+	 * /sys/kernel/debug/lustre/llite/.../io_stage_latency
+	 */
+	struct obd_hist_pcpu	cs_io_hist[CL_IO_STAGE_NR];
 };
 
 int  cl_site_init(struct cl_site *s, struct cl_device *top);
@@ -2095,7 +2127,7 @@ void cl_stack_fini(const struct lu_env *env, struct cl_device *cl);
  * Output client site statistical counters into a buffer. Suitable for
  * ll_rd_*()-style functions.
  */
-int cl_site_stats_print(const struct cl_site *site, struct seq_file *m);
+int cl_site_stats_print(struct cl_site *site, struct seq_file *m);
 
 /**
  * \name helpers
@@ -2610,8 +2642,9 @@ struct cl_sync_io {
 /** direct IO pages */
 struct ll_dio_pages {
 	/*
-	 * page array to be written. we don't support
-	 * partial pages except the last one.
+	 * page array to be written. we don't support partial pages except
+	 * the last one, or the first one when the pages are bounce buffers
+	 * for unaligned DIO (see cl_sub_dio::csd_unaligned).
 	 */
 	struct page             **ldp_pages;
 	/** # of pages in the array. */
@@ -2639,7 +2672,9 @@ struct cl_sub_dio {
 	ssize_t			csd_bytes;
 	struct cl_dio_aio	*csd_ll_aio;
 	struct ll_dio_pages	csd_dio_pages;
-	unsigned		csd_creator_free:1;
+	unsigned		csd_creator_free:1,
+	/* csd_dio_pages are pool bounce pages, released by the creator */
+				csd_unaligned:1;
 };
 #if defined(HAVE_DIRECTIO_ITER) || defined(HAVE_IOV_ITER_RW) || \
 	defined(HAVE_DIRECTIO_2ARGS)
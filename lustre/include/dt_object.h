@@ -2238,6 +2238,7 @@ int dt_declare_version_set(const struct lu_env *env, struct dt_object *o,
 void dt_version_set(const struct lu_env *env, struct dt_object *o,
                     dt_obj_version_t version, struct thandle *th);
 dt_obj_version_t dt_version_get(const struct lu_env *env, struct dt_object *o);
+__u64 dt_xattr_version_get(const struct lu_env *env, struct dt_object *o);
 
 
 int dt_read(const struct lu_env *env, struct dt_object *dt,
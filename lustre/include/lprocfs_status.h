@@ -1090,6 +1090,28 @@ static inline
 unsigned long lprocfs_oh_sum(struct obd_histogram *oh)
 { return 0; }
 static inline
+void lprocfs_oh_tally_pcpu(struct obd_hist_pcpu *oh, unsigned int value)
+{ return; }
+static inline
+void lprocfs_oh_tally_log2_pcpu(struct obd_hist_pcpu *oh, unsigned int value)
+{ return; }
+static inline
+int lprocfs_oh_alloc_pcpu(struct obd_hist_pcpu *oh)
+{ return 0; }
+static inline
+void lprocfs_oh_clear_pcpu(struct obd_hist_pcpu *oh)
+{ return; }
+static inline
+void lprocfs_oh_release_pcpu(struct obd_hist_pcpu *oh)
+{ return; }
+static inline
+unsigned long lprocfs_oh_sum_pcpu(struct obd_hist_pcpu *oh)
+{ return 0; }
+static inline
+unsigned long lprocfs_oh_counter_pcpu(struct obd_hist_pcpu *oh,
+				      unsigned int value)
+{ return 0; }
+static inline
 void lprocfs_stats_collect(struct lprocfs_stats *stats, int idx,
                            struct lprocfs_counter *cnt)
 { return; }
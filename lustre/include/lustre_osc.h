@@ -129,13 +129,19 @@ struct osc_io {
 	/** true if this io has CAP_SYS_RESOURCE */
 			   oi_cap_sys_resource:1,
 	/** true if this io issued by readahead */
-			   oi_is_readahead:1;
+			   oi_is_readahead:1,
+	/** srvlock of the pages in oi_active_pages */
+			   oi_active_srvlock:1;
 	/** how many LRU pages are reserved for this IO */
 	unsigned long	   oi_lru_reserved;
 
 	/** active extents, we know how many bytes is going to be written,
 	 * so having an active extent will prevent it from being fragmented */
 	struct osc_extent *oi_active;
+	/** pages queued to oi_active but not added to it yet, so that
+	 * writers of one object don't take its lock for every page */
+	struct list_head   oi_active_pages;
+	unsigned int	   oi_active_nr;
 	/** partially truncated extent, we need to hold this extent to prevent
 	 * page writeback from happening. */
 	struct osc_extent *oi_trunc;
@@ -528,6 +534,11 @@ struct osc_page {
 	 * If the page is in osc_object::oo_tree.
 	 */
 				ops_intree:1;
+	/**
+	 * Index of the client_obd::cl_lru_parts list the page is added to.
+	 * Kept next to the bit fields above, where it fills their padding.
+	 */
+	unsigned short		ops_lru_part;
 	/**
 	 * lru page list. See osc_lru_{del|use}() in osc_page.c for usage.
 	 */
@@ -177,6 +177,16 @@ enum obd_cl_sem_lock_class {
 
 struct mdc_rpc_lock;
 struct obd_import;
+/** Per CPU partition list of LRU pages of a client_obd */
+struct cl_lru_part {
+	/** Lock for LRU page list */
+	spinlock_t		clp_lock;
+	/** List of LRU pages, of this CPU partition's memory */
+	struct list_head	clp_list;
+	/** # of pages in clp_list, protected by clp_lock */
+	long			clp_in_list;
+} ____cacheline_aligned;
+
 struct client_obd {
 	struct rw_semaphore	 cl_sem;
 	struct obd_uuid		 cl_target_uuid;
@@ -281,6 +291,19 @@ struct client_obd {
 	u32			cl_max_pages_per_rpc;
 	u32			cl_max_rpcs_in_flight;
 	u32			cl_max_short_io_bytes;
+	/* adaptive RPCs in flight, see osc_rif_update(). If enabled, BRW
+	 * RPCs in flight are limited by cl_rif_limit, which moves within
+	 * [cl_rif_min, cl_max_rpcs_in_flight] by BRW reply feedback. All
+	 * protected by cl_loi_list_lock. */
+	u32			cl_rif_auto:1;
+	u32			cl_rif_limit;
+	u32			cl_rif_min;
+	u32			cl_rif_acked;	/* replies since last change */
+	u64			cl_rif_rtt_min;	/* usec, baseline RPC time */
+	u64			cl_rif_rtt_avg;	/* usec, moving average */
+	time64_t		cl_rif_rtt_min_time;
+	u64			cl_rif_increases;
+	u64			cl_rif_decreases;
 	ktime_t			cl_stats_init;
 	struct obd_histogram	cl_read_rpc_hist;
 	struct obd_histogram	cl_write_rpc_hist;
@@ -313,10 +336,11 @@ struct client_obd {
 	 * reclaim is sync, initiated by IO thread when the LRU slots are
 	 * in shortage. */
 	__u64                    cl_lru_reclaim;
-	/** List of LRU pages for this client_obd */
-	struct list_head         cl_lru_list;
-	/** Lock for LRU page list */
-	spinlock_t		 cl_lru_list_lock;
+	/** LRU pages of this client_obd, one list per CPU partition, so that
+	 * threads on different NUMA nodes don't contend on one lock */
+	struct cl_lru_part	*cl_lru_parts;
+	/** # of entries in cl_lru_parts */
+	int			 cl_lru_nparts;
 	/** # of unstable pages in this client_obd.
 	 * An unstable page is a page state that WRITE RPC has finished but
 	 * the transaction has NOT yet committed. */
@@ -964,6 +988,9 @@ struct md_readdir_info {
 			       void *data, int flag);
 	/* if striped directory is partially read, the result is stored here */
 	int mr_partial_readdir_rc;
+	/* only return a page already in the page cache, never read it from
+	 * the MDT, -ENODATA if it isn't cached */
+	bool mr_cached_only;
 };
 
 struct md_enqueue_info;
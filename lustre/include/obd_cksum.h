@@ -31,6 +31,7 @@
 
 #ifndef __OBD_CKSUM
 #define __OBD_CKSUM
+#include <linux/scatterlist.h>
 #include <libcfs/libcfs.h>
 #include <libcfs/libcfs_crypto.h>
 #include <uapi/linux/lustre/lustre_idl.h>
@@ -133,6 +134,58 @@ enum cksum_types obd_cksum_type_select(const char *obd_name,
 	return obd_cksum_type_unpack(flag);
 }
 
+/* Page fragments of a bulk hashed by one crypto update */
+#define OBD_CKSUM_PAGES_BATCH	8
+
+/*
+ * Batch of page fragments to checksum, so that the hash of a bulk is updated
+ * once per OBD_CKSUM_PAGES_BATCH pages instead of once per page.
+ */
+struct obd_cksum_pages {
+	struct ahash_request	*ocp_req;
+	unsigned int		 ocp_count;
+	unsigned int		 ocp_len;
+	struct scatterlist	 ocp_sg[OBD_CKSUM_PAGES_BATCH];
+};
+
+static inline void obd_cksum_pages_init(struct obd_cksum_pages *ocp,
+					struct ahash_request *req)
+{
+	ocp->ocp_req = req;
+	ocp->ocp_count = 0;
+	ocp->ocp_len = 0;
+	sg_init_table(ocp->ocp_sg, OBD_CKSUM_PAGES_BATCH);
+}
+
+/* Hash the page fragments batched so far, must be called before final. */
+static inline int obd_cksum_pages_flush(struct obd_cksum_pages *ocp)
+{
+	int rc;
+
+	if (ocp->ocp_count == 0)
+		return 0;
+
+	sg_mark_end(&ocp->ocp_sg[ocp->ocp_count - 1]);
+	rc = cfs_crypto_hash_update_sg(ocp->ocp_req, ocp->ocp_sg,
+				       ocp->ocp_len);
+	obd_cksum_pages_init(ocp, ocp->ocp_req);
+
+	return rc;
+}
+
+static inline int obd_cksum_pages_add(struct obd_cksum_pages *ocp,
+				      struct page *page, unsigned int offset,
+				      unsigned int len)
+{
+	sg_set_page(&ocp->ocp_sg[ocp->ocp_count++], page, len,
+		    offset & ~PAGE_MASK);
+	ocp->ocp_len += len;
+	if (ocp->ocp_count == OBD_CKSUM_PAGES_BATCH)
+		return obd_cksum_pages_flush(ocp);
+
+	return 0;
+}
+
 /* Checksum algorithm names. Must be defined in the same order as the
  * OBD_CKSUM_* flags. */
 #define DECLARE_CKSUM_NAME const char *const cksum_name[] = {"crc32", "adler", \
@@ -1212,6 +1212,7 @@ struct lov_mds_md_v1 {            /* LOV EA mds/wire data (little-endian) */
 #define XATTR_NAME_LINK         "trusted.link"
 #define XATTR_NAME_FID          "trusted.fid"
 #define XATTR_NAME_VERSION      "trusted.version"
+#define XATTR_NAME_XATTR_VERSION "trusted.xattr_version"
 #define XATTR_NAME_SOM		"trusted.som"
 #define XATTR_NAME_HSM		"trusted.hsm"
 #define XATTR_NAME_LFSCK_BITMAP "trusted.lfsck_bitmap"
@@ -1343,6 +1344,10 @@ lov_mds_md_max_stripe_count(__kernel_size_t buf_size, __u32 lmm_magic)
 #define OBD_MD_NAMEHASH      (0x4000000000000000ULL) /* use hash instead of name
 						      * in case of encryption
 						      */
+#define OBD_MD_FLXATTRVER    (0x8000000000000000ULL) /* xattr version, cached
+						      * xattrs are still valid
+						      * if it is unchanged
+						      */
 
 #define OBD_MD_FLALLQUOTA (OBD_MD_FLUSRQUOTA | \
 			   OBD_MD_FLGRPQUOTA | \
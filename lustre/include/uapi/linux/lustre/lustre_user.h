@@ -636,6 +636,7 @@ struct ll_ioc_lease_id {
 #define LL_IOC_PCC_DETACH_BY_FID	_IOW('f', 252, struct lu_pcc_detach_fid)
 #define LL_IOC_PCC_STATE		_IOR('f', 252, struct lu_pcc_state)
 #define LL_IOC_PROJECT			_IOW('f', 253, struct lu_project)
+#define LL_IOC_STATAHEAD		_IOW('f', 254, struct ll_statahead_list)
 
 #ifndef	FS_IOC_FSGETXATTR
 /*
@@ -2676,6 +2677,7 @@ struct lu_heat {
 enum lu_pcc_type {
 	LU_PCC_NONE = 0,
 	LU_PCC_READWRITE,
+	LU_PCC_READONLY,
 	LU_PCC_MAX
 };
 
@@ -2686,6 +2688,8 @@ static inline const char *pcc_type2string(enum lu_pcc_type type)
 		return "none";
 	case LU_PCC_READWRITE:
 		return "readwrite";
+	case LU_PCC_READONLY:
+		return "readonly";
 	default:
 		return "fault";
 	}
@@ -2751,6 +2755,20 @@ struct fid_array {
 };
 #define OBD_MAX_FIDS_IN_ARRAY	4096
 
+/* LL_IOC_STATAHEAD: entries of a directory to be stat'ed ahead, either
+ * NUL terminated names, or FIDs if the ioctl is done on ".lustre/fid"
+ */
+struct ll_statahead_list {
+	__u32	sal_count;	/* number of entries in sal_buf */
+	__u32	sal_flags;	/* LL_SA_LIST_* */
+	__u32	sal_size;	/* size of sal_buf in bytes */
+	__u32	sal_padding;
+	char	sal_buf[0];
+};
+
+#define LL_SA_LIST_FID		0x00000001	/* sal_buf is a lu_fid array */
+#define LL_SA_LIST_MAX_SIZE	(1U << 20)
+
 /* more types could be defined upon need for more complex
  * format to be used in foreign symlink LOV/LMV EAs, like
  * one to describe a delimiter string and occurence number
@@ -450,8 +450,8 @@ int client_obd_setup(struct obd_device *obd, struct lustre_cfg *lcfg)
 	atomic_set(&cli->cl_lru_shrinkers, 0);
 	atomic_long_set(&cli->cl_lru_busy, 0);
 	atomic_long_set(&cli->cl_lru_in_list, 0);
-	INIT_LIST_HEAD(&cli->cl_lru_list);
-	spin_lock_init(&cli->cl_lru_list_lock);
+	cli->cl_lru_parts = NULL;
+	cli->cl_lru_nparts = 0;
 	atomic_long_set(&cli->cl_unstable_count, 0);
 	INIT_LIST_HEAD(&cli->cl_shrink_list);
 	INIT_LIST_HEAD(&cli->cl_grant_chain);
@@ -506,6 +506,10 @@ int client_obd_setup(struct obd_device *obd, struct lustre_cfg *lcfg)
 			cli->cl_max_rpcs_in_flight = OBD_MAX_RIF_DEFAULT;
 	}
 
+	cli->cl_rif_auto = 0;
+	cli->cl_rif_limit = cli->cl_max_rpcs_in_flight;
+	cli->cl_rif_min = 1;
+
 	spin_lock_init(&cli->cl_mod_rpcs_hist.oh_lock);
 	cli->cl_max_mod_rpcs_in_flight = 0;
 	cli->cl_mod_rpcs_in_flight = 0;
@@ -524,6 +528,19 @@ int client_obd_setup(struct obd_device *obd, struct lustre_cfg *lcfg)
 			GOTO(err, rc = -ENOMEM);
 	}
 
+	if (connect_op != MGS_CONNECT) {
+		int i;
+
+		cli->cl_lru_nparts = cfs_cpt_number(cfs_cpt_tab);
+		OBD_ALLOC_PTR_ARRAY(cli->cl_lru_parts, cli->cl_lru_nparts);
+		if (cli->cl_lru_parts == NULL)
+			GOTO(err, rc = -ENOMEM);
+		for (i = 0; i < cli->cl_lru_nparts; i++) {
+			spin_lock_init(&cli->cl_lru_parts[i].clp_lock);
+			INIT_LIST_HEAD(&cli->cl_lru_parts[i].clp_list);
+		}
+	}
+
 	rc = ldlm_get_ref();
 	if (rc) {
 		CERROR("ldlm_get_ref failed: %d\n", rc);
@@ -602,6 +619,9 @@ err:
 		OBD_FREE(cli->cl_mod_tag_bitmap,
 			 BITS_TO_LONGS(OBD_MAX_RIF_MAX) * sizeof(long));
 	cli->cl_mod_tag_bitmap = NULL;
+	if (cli->cl_lru_parts != NULL)
+		OBD_FREE_PTR_ARRAY(cli->cl_lru_parts, cli->cl_lru_nparts);
+	cli->cl_lru_parts = NULL;
 
 	RETURN(rc);
 }
@@ -625,6 +645,9 @@ int client_obd_cleanup(struct obd_device *obd)
 		OBD_FREE(cli->cl_mod_tag_bitmap,
 			 BITS_TO_LONGS(OBD_MAX_RIF_MAX) * sizeof(long));
 	cli->cl_mod_tag_bitmap = NULL;
+	if (cli->cl_lru_parts != NULL)
+		OBD_FREE_PTR_ARRAY(cli->cl_lru_parts, cli->cl_lru_nparts);
+	cli->cl_lru_parts = NULL;
 
 	RETURN(0);
 }
@@ -344,6 +344,12 @@ static int ll_revalidate_dentry(struct dentry *dentry,
 	if (lookup_flags & LOOKUP_RCU)
 		return -ECHILD;
 
+	/* found valid in d_compare(), so no need to ask MDT */
+	if (!dentry->d_inode && test_bit(LL_SBI_DIR_LEASE,
+					 ll_i2sbi(dir)->ll_flags) &&
+	    ll_d2d(dentry) && ll_d2d(dentry)->lld_dir_lease)
+		atomic_inc(&ll_i2sbi(dir)->ll_neg_hit);
+
 	if (dentry_may_statahead(dir, dentry))
 		ll_revalidate_statahead(dir, &dentry, dentry->d_inode == NULL);
 
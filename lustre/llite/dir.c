@@ -160,6 +160,27 @@ struct page *ll_get_dir_page(struct inode *dir, struct md_op_data *op_data,
 	return page;
 }
 
+/*
+ * Same as ll_get_dir_page(), but for a page which is already in the page
+ * cache only, no READPAGE RPC is sent. Returns ERR_PTR(-ENODATA) if the page
+ * isn't cached.
+ */
+struct page *ll_get_cached_dir_page(struct inode *dir,
+				    struct md_op_data *op_data, __u64 offset)
+{
+	struct md_readdir_info mrinfo = {
+					.mr_blocking_ast = ll_md_blocking_ast,
+					.mr_cached_only = true };
+	struct page *page;
+	int rc;
+
+	rc = md_read_page(ll_i2mdexp(dir), op_data, &mrinfo, offset, &page);
+	if (rc != 0)
+		return ERR_PTR(rc);
+
+	return page;
+}
+
 void ll_release_page(struct inode *inode, struct page *page,
 		     bool remove)
 {
@@ -181,6 +202,179 @@ void ll_release_page(struct inode *inode, struct page *page,
 	put_page(page);
 }
 
+/*
+ * Readdir prefetch.
+ *
+ * Directory pages are chained by hash, the start of a page is only known
+ * once the previous one is read, so pages of one directory can't be fetched
+ * in parallel. Instead a work item reads pages of the directory ahead of
+ * readdir, which then finds them in cache, and each stripe of a striped
+ * directory is read ahead by its own work item, so that stripes are fetched
+ * from their MDTs concurrently while LMV merges them by hash.
+ *
+ * Like file readahead, the next window is read once readdir has reached the
+ * middle of the previous one, see lli_dir_prefetch_trigger.
+ */
+struct ll_dir_prefetch_work {
+	struct work_struct	ldpw_work;
+	struct inode		*ldpw_dir;	/* plain dir or dir stripe */
+	__u64			ldpw_hash;	/* hash of the first page */
+	unsigned int		ldpw_pages;	/* pages to read */
+};
+
+static void ll_dir_prefetch_handle_work(struct work_struct *wq)
+{
+	struct ll_dir_prefetch_work *work;
+	struct md_op_data *op_data = NULL;
+	struct ll_inode_info *lli;
+	struct inode *dir;
+	__u64 trigger = MDS_DIR_END_OFF;
+	__u64 hash;
+	unsigned int i;
+
+	ENTRY;
+
+	work = container_of(wq, struct ll_dir_prefetch_work, ldpw_work);
+	dir = work->ldpw_dir;
+	lli = ll_i2info(dir);
+	hash = work->ldpw_hash;
+
+	for (i = 0; i < work->ldpw_pages && hash != MDS_DIR_END_OFF; i++) {
+		struct lu_dirpage *dp;
+		struct page *page;
+
+		op_data = ll_prep_md_op_data(op_data, dir, dir, NULL, 0, 0,
+					     LUSTRE_OPC_ANY, dir);
+		if (IS_ERR(op_data)) {
+			op_data = NULL;
+			break;
+		}
+		/* restriped meanwhile, LMV reads it a different way */
+		if (op_data->op_mea1) {
+			ll_unlock_md_op_lsm(op_data);
+			break;
+		}
+
+		page = ll_get_dir_page(dir, op_data, hash, NULL);
+		ll_unlock_md_op_lsm(op_data);
+		if (IS_ERR(page)) {
+			CDEBUG(D_READA, "prefetch "DFID" at %#llx: rc = %ld\n",
+			       PFID(ll_inode2fid(dir)), hash, PTR_ERR(page));
+			break;
+		}
+
+		if (i == work->ldpw_pages / 2)
+			trigger = hash;
+
+		dp = page_address(page);
+		hash = le64_to_cpu(dp->ldp_hash_end);
+		ll_release_page(dir, page,
+				le32_to_cpu(dp->ldp_flags) & LDF_COLLIDE);
+	}
+
+	if (op_data)
+		ll_finish_md_op_data(op_data);
+
+	/* stop at the end of directory and on error */
+	if (hash == MDS_DIR_END_OFF || i < work->ldpw_pages)
+		trigger = MDS_DIR_END_OFF;
+
+	spin_lock(&lli->lli_sa_lock);
+	lli->lli_dir_prefetch_hash = hash;
+	lli->lli_dir_prefetch_trigger = trigger;
+	spin_unlock(&lli->lli_sa_lock);
+
+	iput(dir);
+	OBD_FREE_PTR(work);
+	EXIT;
+}
+
+/*
+ * read @pages pages of @dir from @next on, if readdir at @pos is far enough
+ * in the window read before
+ */
+static void ll_dir_prefetch_one(struct inode *dir, __u64 pos, __u64 next,
+				unsigned int pages)
+{
+	struct ll_sb_info *sbi = ll_i2sbi(dir);
+	struct ll_inode_info *lli = ll_i2info(dir);
+	struct ll_dir_prefetch_work *work;
+	__u64 hash;
+
+	spin_lock(&lli->lli_sa_lock);
+	if (pos < lli->lli_dir_prefetch_trigger) {
+		spin_unlock(&lli->lli_sa_lock);
+		return;
+	}
+	/* no other prefetch until this one is done */
+	lli->lli_dir_prefetch_trigger = MDS_DIR_END_OFF;
+	hash = max(next, lli->lli_dir_prefetch_hash);
+	spin_unlock(&lli->lli_sa_lock);
+
+	OBD_ALLOC_PTR(work);
+	if (work)
+		work->ldpw_dir = igrab(dir);
+	if (!work || !work->ldpw_dir) {
+		if (work)
+			OBD_FREE_PTR(work);
+		ll_dir_prefetch_reset(dir);
+		return;
+	}
+
+	INIT_WORK(&work->ldpw_work, ll_dir_prefetch_handle_work);
+	work->ldpw_hash = hash;
+	work->ldpw_pages = pages;
+	ll_stats_ops_tally(sbi, LPROC_LL_READDIR_PREFETCH, 1);
+	queue_work(sbi->ll_dir_prefetch_wq, &work->ldpw_work);
+}
+
+/**
+ * Start reading pages of \a dir ahead of readdir at hash \a pos.
+ *
+ * Called once readdir got the page at \a pos, prefetch starts from the next
+ * one at \a next, so that it doesn't fetch the page readdir just fetched.
+ *
+ * For a striped directory every stripe is read ahead, and the prefetch
+ * window is split among stripes. \a op_data holds the stripe layout.
+ */
+void ll_dir_prefetch(struct inode *dir, struct md_op_data *op_data, __u64 pos,
+		     __u64 next)
+{
+	struct lmv_stripe_md *lsm = op_data->op_mea1;
+	unsigned int pages = ll_i2sbi(dir)->ll_dir_prefetch_pages;
+	int i;
+
+	if (!pages || next == MDS_DIR_END_OFF)
+		return;
+
+	if (!lsm) {
+		ll_dir_prefetch_one(dir, pos, next, max(pages, 2U));
+		return;
+	}
+
+	if (!lmv_dir_striped(lsm))
+		return;
+
+	pages = max(pages / lsm->lsm_md_stripe_count, 2U);
+	for (i = 0; i < lsm->lsm_md_stripe_count; i++) {
+		struct inode *stripe = lsm->lsm_md_oinfo[i].lmo_root;
+
+		if (stripe)
+			ll_dir_prefetch_one(stripe, pos, next, pages);
+	}
+}
+
+/* directory pages were dropped, so is what was read ahead */
+void ll_dir_prefetch_reset(struct inode *dir)
+{
+	struct ll_inode_info *lli = ll_i2info(dir);
+
+	spin_lock(&lli->lli_sa_lock);
+	lli->lli_dir_prefetch_hash = 0;
+	lli->lli_dir_prefetch_trigger = 0;
+	spin_unlock(&lli->lli_sa_lock);
+}
+
 #ifdef HAVE_DIR_CONTEXT
 int ll_dir_read(struct inode *inode, __u64 *ppos, struct md_op_data *op_data,
 		struct dir_context *ctx, int *partial_readdir_rc)
@@ -221,6 +415,8 @@ int ll_dir_read(struct inode *inode, __u64 *ppos, struct md_op_data *op_data,
 
 		hash = MDS_DIR_END_OFF;
 		dp = page_address(page);
+		ll_dir_prefetch(inode, op_data, pos,
+				le64_to_cpu(dp->ldp_hash_end));
 		for (ent = lu_dirent_start(dp); ent != NULL && !done;
 		     ent = lu_dirent_next(ent)) {
 			__u16          type;
@@ -1800,6 +1996,8 @@ out_rmdir:
 	}
 	case LL_IOC_RMFID:
 		RETURN(ll_rmfid(file, (void __user *)arg));
+	case LL_IOC_STATAHEAD:
+		RETURN(ll_ioc_statahead(file, (void __user *)arg));
 	case LL_IOC_LOV_SWAP_LAYOUTS:
 		RETURN(-EPERM);
 	case IOC_OBD_STATFS:
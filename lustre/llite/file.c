@@ -775,7 +775,7 @@ static int ll_local_open(struct file *file, struct lookup_intent *it,
 	}
 
 	file->private_data = fd;
-	ll_readahead_init(inode, &fd->fd_ras);
+	ll_readahead_init(inode, fd);
 	fd->fd_omode = it->it_flags & (FMODE_READ | FMODE_WRITE | FMODE_EXEC);
 
 	RETURN(0);
@@ -1636,6 +1636,231 @@ static void ll_heat_add(struct inode *inode, enum cl_io_type iot,
 	spin_unlock(&lli->lli_heat_lock);
 }
 
+/*
+ * Zero-copy write: data written to a range that is not in the page cache
+ * is not expected to be read back soon, so copying it into page cache pages
+ * only costs memory bandwidth.  Such writes take the DIO path, where the
+ * user pages are pinned into the BRW bulk directly.
+ */
+static bool ll_zerocopy_write_check(struct inode *inode, loff_t pos,
+				    size_t count)
+{
+#ifdef HAVE_FILEMAP_RANGE_HAS_PAGE
+	return !filemap_range_has_page(inode->i_mapping, pos, pos + count - 1);
+#else
+	return inode->i_mapping->nrpages == 0;
+#endif
+}
+
+/*
+ * Hybrid I/O: large buffered reads and writes spend most of their CPU time
+ * on page cache management, so above a size threshold they are sent through
+ * the (parallel) DIO path instead.  Only sync I/O from user buffers to files
+ * that are not mmapped is switched, and only while the unused part of the
+ * client cache is below ll_hybrid_io_lru_pct, or for a zero-copy write.
+ */
+static bool ll_hybrid_io_check(struct file *file, struct vvp_io_args *args,
+			       enum cl_io_type iot, loff_t pos, size_t count,
+			       bool *zerocopy)
+{
+#if defined(HAVE_DIO_ITER) && defined(IOCB_DIRECT)
+	struct inode *inode = file_inode(file);
+	struct ll_sb_info *sbi = ll_i2sbi(inode);
+	struct cl_client_cache *cache = sbi->ll_cache;
+	bool zc = iot == CIT_WRITE && ll_sbi_has_zerocopy_write(sbi);
+	size_t threshold;
+
+	*zerocopy = false;
+	if (!ll_sbi_has_hybrid_io(sbi) && !zc)
+		return false;
+
+	if (file->f_flags & (O_DIRECT | O_APPEND))
+		return false;
+
+	if (iot == CIT_READ)
+		threshold = sbi->ll_hybrid_io_read_threshold_bytes;
+	else
+		threshold = sbi->ll_hybrid_io_write_threshold_bytes;
+	if (count < threshold)
+		return false;
+
+	if (!is_sync_kiocb(args->u.normal.via_iocb) ||
+	    iov_iter_is_pipe(args->u.normal.via_iter))
+		return false;
+
+	if (IS_ENCRYPTED(inode) || mapping_mapped(file->f_mapping))
+		return false;
+
+	if (zc && ll_zerocopy_write_check(inode, pos, count)) {
+		*zerocopy = true;
+		return true;
+	}
+
+	if (!ll_sbi_has_hybrid_io(sbi))
+		return false;
+
+	if (atomic_long_read(&cache->ccc_lru_left) * 100 >
+	    cache->ccc_lru_max * sbi->ll_hybrid_io_lru_pct)
+		return false;
+
+	return true;
+#else
+	*zerocopy = false;
+	return false;
+#endif
+}
+
+/*
+ * Split the remaining @count bytes of a hybrid I/O at @pos: an unaligned head
+ * and a sub-page tail stay in the page cache, the page aligned middle is done
+ * as DIO if the user buffer is page aligned as well.  Returns true if the
+ * next @per_bytes bytes are to be done as DIO.
+ */
+static bool ll_hybrid_io_chunk(struct iov_iter *iter, loff_t pos, size_t count,
+			       size_t *per_bytes)
+{
+#if defined(HAVE_DIO_ITER) && defined(IOCB_DIRECT)
+	size_t head = pos & ~PAGE_MASK;
+	size_t bytes = count & PAGE_MASK;
+	struct iov_iter i;
+
+	if (head) {
+		*per_bytes = min_t(size_t, *per_bytes, PAGE_SIZE - head);
+		return false;
+	}
+
+	if (!bytes)
+		return false;
+
+	/* a misaligned user buffer would need bounce pages, which costs the
+	 * same copy as the page cache does
+	 */
+	i = *iter;
+	iov_iter_truncate(&i, bytes);
+	if (iov_iter_alignment(&i) & ~PAGE_MASK)
+		return false;
+
+	*per_bytes = bytes;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* strided writes in a row before locks are requested ahead of them */
+#define LL_WRITE_STRIDE_HITS	2
+
+/*
+ * Detect strided writes through @file, and request write locks ahead for the
+ * next ll_write_lockahead_count writes, sized and aligned like the writes of
+ * this writer. The locks are not expanded by the OST, so writers of other
+ * strides of the file don't have to take them back, as they would have with
+ * the locks enqueued by the writes themselves.
+ */
+static void ll_write_stride_update(struct file *file, loff_t pos, size_t bytes)
+{
+	struct ll_file_data *fd = file->private_data;
+	struct ll_write_stride *ws = &fd->fd_write_stride;
+	struct ll_sb_info *sbi = ll_i2sbi(file_inode(file));
+	unsigned int count = sbi->ll_write_lockahead_count;
+	loff_t stride = pos - ws->ws_last_pos;
+	struct llapi_lu_ladvise ladvise = {
+		.lla_advice		= LU_LADVISE_LOCKAHEAD,
+		.lla_lockahead_mode	= MODE_WRITE_USER,
+		.lla_peradvice_flags	= LF_ASYNC,
+	};
+	loff_t next;
+	unsigned int i;
+	int rc;
+
+	if (count == 0 || fd->fd_no_lockahead ||
+	    fd->fd_flags & (LL_FILE_GROUP_LOCKED | LL_FILE_IGNORE_LOCK) ||
+	    file->f_flags & O_APPEND)
+		return;
+
+	/* concurrent writers through the same file only make this miss */
+	if (ws->ws_last_bytes != 0 && bytes == ws->ws_last_bytes &&
+	    stride > bytes && stride == ws->ws_stride) {
+		ws->ws_hits++;
+	} else {
+		ws->ws_stride = stride > 0 ? stride : 0;
+		ws->ws_hits = 0;
+		ws->ws_ahead_pos = pos;
+	}
+	ws->ws_last_pos = pos;
+	ws->ws_last_bytes = bytes;
+
+	if (ws->ws_hits < LL_WRITE_STRIDE_HITS)
+		return;
+
+	for (i = 1; i <= count; i++) {
+		next = pos + i * ws->ws_stride;
+		if (next <= ws->ws_ahead_pos)
+			continue;
+		if (next + bytes > MAX_LFS_FILESIZE)
+			break;
+
+		ladvise.lla_start = next;
+		ladvise.lla_end = next + bytes - 1;
+		rc = ll_file_lock_ahead(file, &ladvise);
+		if (rc == -EOPNOTSUPP) {
+			fd->fd_no_lockahead = true;
+			break;
+		}
+		if (rc < 0)
+			break;
+		ws->ws_ahead_pos = next;
+		ll_stats_ops_tally(sbi, LPROC_LL_WRITE_LOCKAHEAD, 1);
+	}
+}
+
+/*
+ * Request the locks of all stripes of a large read or write at once, so that
+ * they are enqueued on the OSTs in parallel, instead of one after the other as
+ * the IO goes through the stripes. The requests are asynchronous, see
+ * ll_file_lock_ahead(); the IO of each stripe then matches the lock, if it is
+ * granted by the time the IO gets there.
+ *
+ * Lockahead extents are never expanded by the OST, so the locks are requested
+ * up to the end of the file, as far as an uncontended lock would have been
+ * expanded. Later IOs of a sequential reader or writer and readahead are then
+ * covered too, and stripes which already hold such a lock are matched locally
+ * without an RPC. If another client holds a conflicting lock, the request
+ * fails instead of waiting, and the IO enqueues its own lock as usual.
+ */
+static void ll_io_lock_prefetch(struct file *file, enum cl_io_type iot,
+				loff_t pos, size_t count)
+{
+	struct ll_file_data *fd = file->private_data;
+	struct ll_sb_info *sbi = ll_i2sbi(file_inode(file));
+	size_t threshold = sbi->ll_io_lock_prefetch_bytes;
+	struct llapi_lu_ladvise ladvise = {
+		.lla_advice		= LU_LADVISE_LOCKAHEAD,
+		.lla_lockahead_mode	= iot == CIT_READ ? MODE_READ_USER :
+							    MODE_WRITE_USER,
+		.lla_peradvice_flags	= LF_ASYNC,
+		.lla_start		= pos,
+		.lla_end		= MAX_LFS_FILESIZE - 1,
+	};
+	int rc;
+
+	if (threshold == 0 || count < threshold || fd->fd_no_lockahead ||
+	    fd->fd_flags & (LL_FILE_GROUP_LOCKED | LL_FILE_IGNORE_LOCK) ||
+	    (iot == CIT_WRITE && file->f_flags & O_APPEND))
+		return;
+
+	/* the application requests its locks ahead itself */
+	if (fd->ll_lock_no_expand)
+		return;
+
+	rc = ll_file_lock_ahead(file, &ladvise);
+	if (rc == -EOPNOTSUPP)
+		fd->fd_no_lockahead = true;
+	/* LLA_RESULT_{SAME,DIFFERENT}: all stripes were locked already */
+	else if (rc == 0)
+		ll_stats_ops_tally(sbi, LPROC_LL_IO_LOCK_PREFETCH, 1);
+}
+
 static ssize_t
 ll_file_io_generic(const struct lu_env *env, struct vvp_io_args *args,
 		   struct file *file, enum cl_io_type iot,
@@ -1647,6 +1872,7 @@ ll_file_io_generic(const struct lu_env *env, struct vvp_io_args *args,
 	struct ll_sb_info *sbi = ll_i2sbi(inode);
 	struct ll_file_data *fd  = file->private_data;
 	struct range_lock range;
+	loff_t io_start = *ppos;
 	bool range_locked = false;
 	struct cl_io *io;
 	ssize_t result = 0;
@@ -1655,6 +1881,9 @@ ll_file_io_generic(const struct lu_env *env, struct vvp_io_args *args,
 	unsigned int retried = 0, dio_lock = 0;
 	bool is_aio = false;
 	bool is_parallel_dio = false;
+	bool hybrid = false;
+	bool hybrid_dio = false;
+	bool zerocopy = false;
 	struct cl_dio_aio *ci_dio_aio = NULL;
 	size_t per_bytes;
 	bool partial_io = false;
@@ -1672,7 +1901,8 @@ ll_file_io_generic(const struct lu_env *env, struct vvp_io_args *args,
 		max_io_pages = max_cached_pages >> 2;
 
 	io = vvp_env_thread_io(env);
-	if (file->f_flags & O_DIRECT) {
+	hybrid = ll_hybrid_io_check(file, args, iot, *ppos, count, &zerocopy);
+	if (file->f_flags & O_DIRECT || hybrid) {
 		if (file->f_flags & O_APPEND)
 			dio_lock = 1;
 		if (!is_sync_kiocb(args->u.normal.via_iocb))
@@ -1694,6 +1924,8 @@ ll_file_io_generic(const struct lu_env *env, struct vvp_io_args *args,
 			GOTO(out, rc = -ENOMEM);
 	}
 
+	ll_io_lock_prefetch(file, iot, *ppos, count);
+
 restart:
 	/**
 	 * IO block size need be aware of cached page limit, otherwise
@@ -1704,6 +1936,8 @@ restart:
 		per_bytes = count;
 	else
 		per_bytes = min(max_io_pages << PAGE_SHIFT, count);
+	hybrid_dio = hybrid && ll_hybrid_io_chunk(args->u.normal.via_iter,
+						  *ppos, count, &per_bytes);
 	partial_io = per_bytes < count;
 	io = vvp_env_thread_io(env);
 	ll_io_init(io, file, iot, args);
@@ -1711,6 +1945,14 @@ restart:
 	io->ci_dio_lock = dio_lock;
 	io->ci_ndelay_tried = retried;
 	io->ci_parallel_dio = is_parallel_dio;
+	if (hybrid_dio) {
+#ifdef IOCB_DIRECT
+		args->u.normal.via_iocb->ki_flags |= IOCB_DIRECT;
+#endif
+		io->ci_hybrid_switched = 1;
+		if (iot == CIT_WRITE)
+			io->u.ci_wr.wr_sync = 1;
+	}
 
 	if (cl_io_rw_init(env, io, iot, *ppos, per_bytes) == 0) {
 		if (file->f_flags & O_APPEND)
@@ -1726,7 +1968,7 @@ restart:
 		 * See LU-6227 for details.
 		 */
 		if (((iot == CIT_WRITE) ||
-		    (iot == CIT_READ && (file->f_flags & O_DIRECT))) &&
+		    (iot == CIT_READ && ll_io_is_direct(file, io))) &&
 		    !(vio->vui_fd->fd_flags & LL_FILE_GROUP_LOCKED)) {
 			CDEBUG(D_VFSTRACE, "Range lock "RL_FMT"\n",
 			       RL_PARA(&range));
@@ -1787,6 +2029,14 @@ restart:
 				result = 0;
 			}
 		}
+		if (hybrid_dio && zerocopy)
+			ll_stats_ops_tally(sbi, LPROC_LL_ZEROCOPY_WRITE_BYTES,
+					   io->ci_nob);
+		else if (hybrid_dio)
+			ll_stats_ops_tally(sbi, iot == CIT_READ ?
+					   LPROC_LL_HYBRID_READ_BYTES :
+					   LPROC_LL_HYBRID_WRITE_BYTES,
+					   io->ci_nob);
 		count -= io->ci_nob;
 
 		/* prepare IO restart */
@@ -1804,6 +2054,10 @@ restart:
 		}
 	}
 out:
+#ifdef IOCB_DIRECT
+	if (hybrid_dio)
+		args->u.normal.via_iocb->ki_flags &= ~IOCB_DIRECT;
+#endif
 	cl_io_fini(env, io);
 
 	CDEBUG(D_VFSTRACE,
@@ -1860,6 +2114,7 @@ out:
 			ll_stats_ops_tally(ll_i2sbi(inode),
 					   LPROC_LL_WRITE_BYTES, result);
 			fd->fd_write_failed = false;
+			ll_write_stride_update(file, io_start, result);
 		} else if (result == 0 && rc == 0) {
 			rc = io->ci_result;
 			if (rc < 0)
@@ -2037,15 +2292,15 @@ static ssize_t ll_file_read_iter(struct kiocb *iocb, struct iov_iter *to)
 		stale_data = true;
 
 	/**
-	 * Currently when PCC read failed, we do not fall back to the
+	 * Currently when RW-PCC read failed, we do not fall back to the
 	 * normal read path, just return the error.
 	 * The resaon is that: for RW-PCC, the file data may be modified
 	 * in the PCC and inconsistent with the data on OSTs (or file
 	 * data has been removed from the Lustre file system), at this
 	 * time, fallback to the normal read path may read the wrong
 	 * data.
-	 * TODO: for RO-PCC (readonly PCC), fall back to normal read
-	 * path: read data from data copy on OSTs.
+	 * For RO-PCC (readonly PCC), pcc_file_read_iter() falls back to
+	 * the normal read path on error, the data copy on OSTs is valid.
 	 */
 	result = pcc_file_read_iter(iocb, to, &cached);
 	if (cached)
@@ -5304,6 +5559,9 @@ int ll_getattr_dentry(struct dentry *de, struct kstat *stat, u32 request_mask,
 	if (dentry_may_statahead(dir, de))
 		ll_start_statahead(dir, de, need_glimpse &&
 				   !(flags & AT_STATX_DONT_SYNC));
+	else
+		ll_statahead_fname_check(dir, de, need_glimpse &&
+					 !(flags & AT_STATX_DONT_SYNC));
 
 	if (flags & AT_STATX_DONT_SYNC)
 		GOTO(fill_attr, rc = 0);
@@ -81,6 +81,8 @@ struct ll_dentry_data {
 	unsigned int			lld_sa_generation;
 	unsigned int			lld_invalid:1;
 	unsigned int			lld_nfs_dentry:1;
+	/* negative dentry made valid under a dir_lease lock */
+	unsigned int			lld_dir_lease:1;
 	struct rcu_head			lld_rcu_head;
 };
 
@@ -180,6 +182,18 @@ struct ll_inode_info {
 			unsigned short			lli_sa_enabled:1;
 			/* generation for statahead */
 			unsigned int			lli_sa_generation;
+			/* numeric suffix of the last stat'ed name, the hash of
+			 * its prefix, and how many names were stat'ed in order,
+			 * see ll_statahead_fname_check() */
+			__u64				lli_sa_fname_index;
+			unsigned int			lli_sa_fname_hash;
+			unsigned int			lli_sa_fname_count;
+			/* readdir prefetch: hash of the first page not
+			 * prefetched yet, and the reader position at which
+			 * prefetch continues from it, see ll_dir_prefetch(),
+			 * protected by lli_sa_lock */
+			__u64				lli_dir_prefetch_hash;
+			__u64				lli_dir_prefetch_trigger;
 			/* rw lock protects lli_lsm_md */
 			struct rw_semaphore		lli_lsm_sem;
 			/* directory stripe information */
@@ -204,6 +218,10 @@ struct ll_inode_info {
 			/* for writepage() only to communicate to fsync */
 			int			lli_async_rc;
 
+			/* read ahead pages discarded unused, for readahead
+			 * feedback of the file handles */
+			atomic_t		lli_ra_discarded;
+
 			/* protect the file heat fields */
 			spinlock_t			lli_heat_lock;
 			__u32				lli_heat_flags;
@@ -271,6 +289,8 @@ struct ll_inode_info {
 	struct rw_semaphore		lli_xattrs_list_rwsem;
 	struct mutex			lli_xattrs_enq_lock;
 	struct list_head		lli_xattrs; /* ll_xattr_entry->xe_list */
+	/* MDT version of lli_xattrs, 0 if unknown, see OBD_MD_FLXATTRVER */
+	__u64				lli_xattrs_version;
 	struct list_head		lli_lccs; /* list of ll_cl_context */
 	seqlock_t			lli_page_inv_lock;
 };
@@ -436,6 +456,8 @@ enum ll_file_flags {
 	LLIF_FOREIGN_REMOVABLE	= 5,
 	/* Xattr cache is filled */
 	LLIF_XATTR_CACHE_FILLED	= 7,
+	/* dir_lease lock of the directory is being requested */
+	LLIF_DIR_LEASE		= 8,
 
 };
 
@@ -569,6 +591,9 @@ static inline struct pcc_inode *ll_i2pcci(struct inode *inode)
 
 /* default range pages */
 #define SBI_DEFAULT_RA_RANGE_PAGES		MiB_TO_PAGES(1ULL)
+#define RA_FEEDBACK_MS_MAX			60000
+/* independent readahead streams tracked per open file */
+#define LL_RA_STREAMS_MAX			4
 
 /* Min range pages */
 #define RA_MIN_MMAP_RANGE_PAGES			16UL
@@ -590,25 +615,50 @@ enum ra_stat {
 	RA_STAT_ASYNC,
 	RA_STAT_FAILED_FAST_READ,
 	RA_STAT_MMAP_RANGE_READ,
+	RA_STAT_FEEDBACK_RAMP_UP,
+	RA_STAT_FEEDBACK_THROTTLE,
+	RA_STAT_NEW_STREAM,
 	_NR_RA_STAT,
 };
 
+/* async readahead works of a CPU partition */
+struct ll_ra_cpt {
+	struct workqueue_struct	*rac_wq;
+	/* works queued and not finished yet */
+	atomic_t		 rac_inflight;
+	/* works queued in total */
+	atomic_t		 rac_queued;
+	/* works queued to other partitions as this one was busy */
+	atomic_t		 rac_redirected;
+	/* usecs from queueing works to starting them, and to run them */
+	struct obd_histogram	 rac_wait_hist;
+	struct obd_histogram	 rac_run_hist;
+} ____cacheline_aligned;
+
 struct ll_ra_info {
 	atomic_t	ra_cur_pages;
 	unsigned long	ra_max_pages;
 	unsigned long	ra_max_pages_per_file;
 	unsigned long	ra_range_pages;
 	unsigned long	ra_max_read_ahead_whole_pages;
-	struct workqueue_struct  *ll_readahead_wq;
+	/* async readahead queues, one per CPU partition */
+	struct ll_ra_cpt *ra_cpts;
+	int		 ra_cpt_count;
 	/*
 	 * Max number of active works could be triggered
-	 * for async readahead.
+	 * for async readahead, shared evenly by the partitions.
 	 */
 	unsigned int ra_async_max_active;
-	/* how many async readahead triggered in flight */
-	atomic_t ra_async_inflight;
 	/* Threshold to control when to trigger async readahead */
 	unsigned long ra_async_pages_per_file_threshold;
+	/*
+	 * If non-zero, size the per-file window to cover this many
+	 * milliseconds of reading at the measured consumption rate,
+	 * see ras_feedback_pages().
+	 */
+	unsigned int ra_feedback_ms;
+	/* readahead streams per open file, see ll_ras_stream() */
+	unsigned int ra_streams;
 };
 
 /* ra_io_arg will be filled in the beginning of ll_readahead with
@@ -701,6 +751,12 @@ enum ll_sbi_flags {
 	LL_SBI_FILE_HEAT,		/* file heat support */
 	LL_SBI_PARALLEL_DIO,		/* parallel (async) O_DIRECT RPCs */
 	LL_SBI_ENCRYPT_NAME,		/* name encryption */
+	LL_SBI_UNALIGNED_DIO,		/* unaligned O_DIRECT via bounce pages */
+	LL_SBI_HYBRID_IO,		/* switch large buffered I/O to DIO */
+	LL_SBI_STATAHEAD_FNAME,		/* statahead numeric suffix names */
+	LL_SBI_DIR_LEASE,		/* lock dir to cache negative lookups */
+	LL_SBI_FAULT_AROUND,		/* map cached pages around mmap fault */
+	LL_SBI_ZEROCOPY_WRITE,		/* large uncached writes done as DIO */
 	LL_SBI_NUM_FLAGS
 };
 
@@ -782,6 +838,17 @@ struct ll_sb_info {
 	atomic_t		  ll_sa_running; /* running statahead thread
 						  * count */
 	atomic_t		  ll_agl_total;  /* AGL thread started count */
+	atomic_t		  ll_neg_hit;	/* negative lookups answered
+						 * by cached dentries */
+	atomic_t		  ll_neg_miss;	/* negative lookups sent to
+						 * MDT */
+	atomic_t		  ll_dir_lease;	/* dir locks taken for
+						 * negative lookups */
+
+	/* readdir prefetch */
+	unsigned int		  ll_dir_prefetch_pages; /* dir pages read
+							  * ahead of readdir */
+	struct workqueue_struct	 *ll_dir_prefetch_wq;
 
 	dev_t			  ll_sdev_orig; /* save s_dev before assign for
 						 * clustred nfs */
@@ -835,6 +902,17 @@ struct ll_sb_info {
 	/* cached file security context xattr name. e.g: security.selinux */
 	char *ll_secctx_name;
 	__u32 ll_secctx_name_size;
+
+	/* hybrid I/O: buffered I/O of at least this size is done as DIO */
+	size_t			  ll_hybrid_io_read_threshold_bytes;
+	size_t			  ll_hybrid_io_write_threshold_bytes;
+	/* only switch while unused client cache is below this percentage */
+	unsigned int		  ll_hybrid_io_lru_pct;
+	/* stride extents locked ahead of strided writers, 0 to disable */
+	unsigned int		  ll_write_lockahead_count;
+	/* IOs at least this large lock all their stripes at once, 0 to
+	 * disable */
+	size_t			  ll_io_lock_prefetch_bytes;
 };
 
 #define SBI_DEFAULT_HEAT_DECAY_WEIGHT	((80 * 256 + 50) / 100)
@@ -844,6 +922,12 @@ struct ll_sb_info {
 #define SBI_DEFAULT_OPENCACHE_THRESHOLD_MS	(100) /* 0.1 second */
 #define SBI_DEFAULT_OPENCACHE_THRESHOLD_MAX_MS	(60000) /* 1 minute */
 
+#define SBI_DEFAULT_HYBRID_IO_READ_THRESHOLD	(8 << 20) /* 8 MiB */
+#define SBI_DEFAULT_HYBRID_IO_WRITE_THRESHOLD	(2 << 20) /* 2 MiB */
+#define SBI_DEFAULT_HYBRID_IO_LRU_PCT		(100)
+/* upper bound of write_lockahead_count */
+#define SBI_MAX_WRITE_LOCKAHEAD_COUNT		(64)
+
 /*
  * per file-descriptor read-ahead data.
  */
@@ -933,11 +1017,31 @@ struct ll_readahead_state {
 	bool		ras_need_increase_window;
 	/* whether ra miss check should be skipped */
 	bool		ras_no_miss_check;
+	/*
+	 * Readahead feedback sampling period: when it started, pages read
+	 * ahead, pages consumed by the reader and pages read ahead it left
+	 * behind seeking elsewhere since then, and lli_ra_discarded of the
+	 * inode when it started.
+	 */
+	ktime_t		ras_fb_start;
+	unsigned long	ras_fb_ra_pages;
+	unsigned long	ras_fb_read_pages;
+	unsigned long	ras_fb_skipped;
+	int		ras_fb_discarded;
+	/* requests given to this stream since it was started */
+	unsigned long	ras_stream_requests;
+	/* jiffies of the last request given to this stream */
+	unsigned long	ras_stream_access;
 };
 
 struct ll_readahead_work {
 	/** File to readahead */
 	struct file			*lrw_file;
+	/** readahead stream of lrw_file the work is for */
+	struct ll_readahead_state	*lrw_ras;
+	/** CPU partition the work is queued to, and when */
+	int				 lrw_cpt;
+	ktime_t				 lrw_queued;
 	pgoff_t				 lrw_start_idx;
 	pgoff_t				 lrw_end_idx;
 	pid_t				 lrw_user_pid;
@@ -949,8 +1053,26 @@ struct ll_readahead_work {
 
 extern struct kmem_cache *ll_file_data_slab;
 struct lustre_handle;
+/*
+ * Write stride detector of an open file, for automatic lockahead. Writers of
+ * a shared file with a strided pattern (e.g. MPI-IO collective writes) would
+ * otherwise fight over the extent locks expanded by the OST.
+ */
+struct ll_write_stride {
+	loff_t		ws_last_pos;	/* start of the last write */
+	size_t		ws_last_bytes;	/* size of the last write */
+	loff_t		ws_stride;	/* distance between write starts */
+	unsigned int	ws_hits;	/* writes in a row matching ws_stride */
+	loff_t		ws_ahead_pos;	/* last stride start locked ahead */
+};
+
 struct ll_file_data {
-	struct ll_readahead_state fd_ras;
+	/* readahead streams, fd_ras_count of them started so far */
+	struct ll_readahead_state fd_ras[LL_RA_STREAMS_MAX];
+	unsigned int fd_ras_count;
+	/* stream given the last read */
+	struct ll_readahead_state *fd_ras_last;
+	spinlock_t fd_ras_lock;
 	struct ll_grouplock fd_grouplock;
 	__u64 lfd_pos;
 	__u32 fd_flags;
@@ -976,6 +1098,9 @@ struct ll_file_data {
 	 * -errno is saved here, and will return to user in close().
 	 */
 	int fd_partial_readdir_rc;
+	struct ll_write_stride fd_write_stride;
+	/* OST doesn't support lockahead, don't request locks ahead of IO */
+	bool fd_no_lockahead;
 };
 
 void llite_tunables_unregister(void);
@@ -1037,6 +1162,29 @@ static inline bool ll_sbi_has_parallel_dio(struct ll_sb_info *sbi)
 	return test_bit(LL_SBI_PARALLEL_DIO, sbi->ll_flags);
 }
 
+static inline bool ll_sbi_has_unaligned_dio(struct ll_sb_info *sbi)
+{
+	return test_bit(LL_SBI_UNALIGNED_DIO, sbi->ll_flags);
+}
+
+static inline bool ll_sbi_has_hybrid_io(struct ll_sb_info *sbi)
+{
+	return test_bit(LL_SBI_HYBRID_IO, sbi->ll_flags);
+}
+
+static inline bool ll_sbi_has_zerocopy_write(struct ll_sb_info *sbi)
+{
+	return test_bit(LL_SBI_ZEROCOPY_WRITE, sbi->ll_flags);
+}
+
+/* I/O is done through ll_direct_IO(), either because of O_DIRECT or because
+ * it was switched there by hybrid I/O
+ */
+static inline bool ll_io_is_direct(struct file *file, struct cl_io *io)
+{
+	return (file->f_flags & O_DIRECT) || io->ci_hybrid_switched;
+}
+
 void ll_ras_enter(struct file *f, loff_t pos, size_t count);
 
 /* llite/lcommon_misc.c */
@@ -1062,10 +1210,13 @@ enum {
 	LPROC_LL_RELEASE,
 	LPROC_LL_MMAP,
 	LPROC_LL_FAULT,
+	LPROC_LL_FAULT_FAST,
+	LPROC_LL_FAULT_AROUND,
 	LPROC_LL_MKWRITE,
 	LPROC_LL_LLSEEK,
 	LPROC_LL_FSYNC,
 	LPROC_LL_READDIR,
+	LPROC_LL_READDIR_PREFETCH,
 	LPROC_LL_SETATTR,
 	LPROC_LL_TRUNC,
 	LPROC_LL_FLOCK,
@@ -1082,12 +1233,18 @@ enum {
 	LPROC_LL_SETXATTR,
 	LPROC_LL_GETXATTR,
 	LPROC_LL_GETXATTR_HITS,
+	LPROC_LL_GETXATTR_REVALIDATED,
 	LPROC_LL_LISTXATTR,
 	LPROC_LL_REMOVEXATTR,
 	LPROC_LL_INODE_PERM,
 	LPROC_LL_FALLOCATE,
 	LPROC_LL_INODE_OCOUNT,
 	LPROC_LL_INODE_OPCLTM,
+	LPROC_LL_HYBRID_READ_BYTES,
+	LPROC_LL_HYBRID_WRITE_BYTES,
+	LPROC_LL_ZEROCOPY_WRITE_BYTES,
+	LPROC_LL_WRITE_LOCKAHEAD,
+	LPROC_LL_IO_LOCK_PREFETCH,
 	LPROC_LL_FILE_OPCODES
 };
 
@@ -1109,7 +1266,14 @@ int ll_get_mdt_idx(struct inode *inode);
 int ll_get_mdt_idx_by_fid(struct ll_sb_info *sbi, const struct lu_fid *fid);
 struct page *ll_get_dir_page(struct inode *dir, struct md_op_data *op_data,
 			      __u64 offset, int *partial_readdir_rc);
+struct page *ll_get_cached_dir_page(struct inode *dir,
+				    struct md_op_data *op_data, __u64 offset);
 void ll_release_page(struct inode *inode, struct page *page, bool remove);
+/* max dir pages read ahead of readdir, per directory */
+#define LL_DIR_PREFETCH_MAX	65536
+void ll_dir_prefetch(struct inode *dir, struct md_op_data *op_data, __u64 pos,
+		     __u64 next);
+void ll_dir_prefetch_reset(struct inode *dir);
 int quotactl_ioctl(struct super_block *sb, struct if_quotactl *qctl);
 
 /* llite/namei.c */
@@ -1133,7 +1297,7 @@ int ll_read_folio(struct file *file, struct folio *folio);
 #endif
 int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 			   struct cl_page *page, struct file *file);
-void ll_readahead_init(struct inode *inode, struct ll_readahead_state *ras);
+void ll_readahead_init(struct inode *inode, struct ll_file_data *fd);
 int vvp_io_write_commit(const struct lu_env *env, struct cl_io *io);
 
 enum lcc_type;
@@ -1512,10 +1676,23 @@ void ll_ra_stats_inc(struct inode *inode, enum ra_stat which);
 #define LL_SA_RUNNING_MAX	256
 #define LL_SA_RUNNING_DEF	16
 
+/* names stat'ed in numeric suffix order before statahead starts for them */
+#define LL_SA_FNAME_MATCH	2
+
+/* statahead not driven by readdir stops after the scanner is quiet this long */
+#define LL_SA_IDLE_SEC		5
+
 #define LL_SA_CACHE_BIT         5
 #define LL_SA_CACHE_SIZE        (1 << LL_SA_CACHE_BIT)
 #define LL_SA_CACHE_MASK        (LL_SA_CACHE_SIZE - 1)
 
+/* what drives statahead of a directory */
+enum ll_sa_pattern {
+	LSA_PATTERN_LS = 0,	/* "ls -l", entries in readdir order */
+	LSA_PATTERN_FNAME,	/* names with an increasing numeric suffix */
+	LSA_PATTERN_LIST,	/* names or FIDs given by LL_IOC_STATAHEAD */
+};
+
 /* per inode struct, for dir only */
 struct ll_statahead_info {
 	struct dentry	       *sai_dentry;
@@ -1545,6 +1722,16 @@ struct ll_statahead_info {
 	unsigned int            sai_ls_all:1,   /* "ls -al", do stat-ahead for
 						 * hidden entries */
 				sai_in_readpage:1;/* statahead is in readdir()*/
+	enum ll_sa_pattern	sai_pattern;
+	time64_t		sai_access_time; /* last scanner access */
+	/* LSA_PATTERN_FNAME: name prefix followed by the next suffix */
+	__u64			sai_fname_index;
+	int			sai_fname_prefix;
+	int			sai_fname_width; /* 0 if not zero padded */
+	char			sai_fname[NAME_MAX + 1];
+	/* LSA_PATTERN_LIST: entries copied from userspace */
+	struct ll_statahead_list *sai_list;
+	size_t			sai_list_size;
 	wait_queue_head_t	sai_waitq;	/* stat-ahead wait queue */
 	struct task_struct	*sai_task;	/* stat-ahead thread */
 	struct task_struct	*sai_agl_task;	/* AGL thread */
@@ -1561,6 +1748,9 @@ struct ll_statahead_info {
 int ll_revalidate_statahead(struct inode *dir, struct dentry **dentry,
 			    bool unplug);
 int ll_start_statahead(struct inode *dir, struct dentry *dentry, bool agl);
+void ll_statahead_fname_check(struct inode *dir, struct dentry *dentry,
+			      bool agl);
+int ll_ioc_statahead(struct file *file, struct ll_statahead_list __user *ulist);
 void ll_authorize_statahead(struct inode *dir, void *key);
 void ll_deauthorize_statahead(struct inode *dir, void *key);
 
@@ -86,6 +86,55 @@ static inline unsigned int ll_get_ra_async_max_active(void)
 	return cfs_cpt_weight(cfs_cpt_tab, CFS_CPT_ANY) >> 1;
 }
 
+static void ll_ra_cpts_fini(struct ll_ra_info *ra)
+{
+	int i;
+
+	if (!ra->ra_cpts)
+		return;
+
+	for (i = 0; i < ra->ra_cpt_count; i++)
+		if (ra->ra_cpts[i].rac_wq)
+			destroy_workqueue(ra->ra_cpts[i].rac_wq);
+	OBD_FREE_PTR_ARRAY(ra->ra_cpts, ra->ra_cpt_count);
+	ra->ra_cpts = NULL;
+}
+
+/*
+ * Set up an async readahead workqueue bound to each CPU partition, so that
+ * readahead runs, and allocates its pages, near the thread reading.
+ */
+static int ll_ra_cpts_init(struct ll_ra_info *ra)
+{
+	int ncpts = cfs_cpt_number(cfs_cpt_tab);
+	int nthrs = max_t(int, DIV_ROUND_UP(ra->ra_async_max_active, ncpts),
+			  1);
+	int rc;
+	int i;
+
+	OBD_ALLOC_PTR_ARRAY(ra->ra_cpts, ncpts);
+	if (!ra->ra_cpts)
+		return -ENOMEM;
+	ra->ra_cpt_count = ncpts;
+
+	for (i = 0; i < ncpts; i++) {
+		struct ll_ra_cpt *rac = &ra->ra_cpts[i];
+
+		spin_lock_init(&rac->rac_wait_hist.oh_lock);
+		spin_lock_init(&rac->rac_run_hist.oh_lock);
+		rac->rac_wq = cfs_cpt_bind_workqueue("ll-readahead-wq",
+						     cfs_cpt_tab, 0, i, nthrs);
+		if (IS_ERR(rac->rac_wq)) {
+			rc = PTR_ERR(rac->rac_wq);
+			rac->rac_wq = NULL;
+			ll_ra_cpts_fini(ra);
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
 static struct ll_sb_info *ll_init_sbi(void)
 {
 	struct ll_sb_info *sbi = NULL;
@@ -116,12 +165,21 @@ static struct ll_sb_info *ll_init_sbi(void)
 	lru_page_max = pages / 2;
 
 	sbi->ll_ra_info.ra_async_max_active = ll_get_ra_async_max_active();
-	sbi->ll_ra_info.ll_readahead_wq =
-		cfs_cpt_bind_workqueue("ll-readahead-wq", cfs_cpt_tab,
-				       0, CFS_CPT_ANY,
-				       sbi->ll_ra_info.ra_async_max_active);
-	if (IS_ERR(sbi->ll_ra_info.ll_readahead_wq))
-		GOTO(out_pcc, rc = PTR_ERR(sbi->ll_ra_info.ll_readahead_wq));
+	rc = ll_ra_cpts_init(&sbi->ll_ra_info);
+	if (rc)
+		GOTO(out_pcc, rc);
+
+	/* readdir prefetch is mostly waiting for the MDTs, one thread per
+	 * CPU allows to read that many stripes in parallel */
+	sbi->ll_dir_prefetch_wq = cfs_cpt_bind_workqueue("ll-dir-prefetch",
+					cfs_cpt_tab, 0, CFS_CPT_ANY,
+					cfs_cpt_weight(cfs_cpt_tab,
+						       CFS_CPT_ANY));
+	if (IS_ERR(sbi->ll_dir_prefetch_wq)) {
+		rc = PTR_ERR(sbi->ll_dir_prefetch_wq);
+		sbi->ll_dir_prefetch_wq = NULL;
+		GOTO(out_destroy_ra, rc);
+	}
 
 	/* initialize ll_cache data */
 	sbi->ll_cache = cl_cache_init(lru_page_max);
@@ -158,8 +216,8 @@ static struct ll_sb_info *ll_init_sbi(void)
 	sbi->ll_ra_info.ra_async_pages_per_file_threshold =
 				sbi->ll_ra_info.ra_max_pages_per_file;
 	sbi->ll_ra_info.ra_range_pages = SBI_DEFAULT_RA_RANGE_PAGES;
+	sbi->ll_ra_info.ra_streams = LL_RA_STREAMS_MAX;
 	sbi->ll_ra_info.ra_max_read_ahead_whole_pages = -1;
-	atomic_set(&sbi->ll_ra_info.ra_async_inflight, 0);
 
 	set_bit(LL_SBI_VERBOSE, sbi->ll_flags);
 #ifdef CONFIG_ENABLE_CHECKSUM
@@ -181,10 +239,14 @@ static struct ll_sb_info *ll_init_sbi(void)
 	atomic_set(&sbi->ll_sa_wrong, 0);
 	atomic_set(&sbi->ll_sa_running, 0);
 	atomic_set(&sbi->ll_agl_total, 0);
+	atomic_set(&sbi->ll_neg_hit, 0);
+	atomic_set(&sbi->ll_neg_miss, 0);
+	atomic_set(&sbi->ll_dir_lease, 0);
 	set_bit(LL_SBI_AGL_ENABLED, sbi->ll_flags);
 	set_bit(LL_SBI_FAST_READ, sbi->ll_flags);
 	set_bit(LL_SBI_TINY_WRITE, sbi->ll_flags);
 	set_bit(LL_SBI_PARALLEL_DIO, sbi->ll_flags);
+	set_bit(LL_SBI_UNALIGNED_DIO, sbi->ll_flags);
 	ll_sbi_set_encrypt(sbi, true);
 	ll_sbi_set_name_encrypt(sbi, true);
 
@@ -194,6 +256,13 @@ static struct ll_sb_info *ll_init_sbi(void)
 	INIT_LIST_HEAD(&sbi->ll_squash.rsi_nosquash_nids);
 	spin_lock_init(&sbi->ll_squash.rsi_lock);
 
+	/* hybrid I/O is disabled by default */
+	sbi->ll_hybrid_io_read_threshold_bytes =
+		SBI_DEFAULT_HYBRID_IO_READ_THRESHOLD;
+	sbi->ll_hybrid_io_write_threshold_bytes =
+		SBI_DEFAULT_HYBRID_IO_WRITE_THRESHOLD;
+	sbi->ll_hybrid_io_lru_pct = SBI_DEFAULT_HYBRID_IO_LRU_PCT;
+
 	/* Per-filesystem file heat */
 	sbi->ll_heat_decay_weight = SBI_DEFAULT_HEAT_DECAY_WEIGHT;
 	sbi->ll_heat_period_second = SBI_DEFAULT_HEAT_PERIOD_SECOND;
@@ -210,7 +279,9 @@ out_destroy_ra:
 		cl_cache_decref(sbi->ll_cache);
 		sbi->ll_cache = NULL;
 	}
-	destroy_workqueue(sbi->ll_ra_info.ll_readahead_wq);
+	if (sbi->ll_dir_prefetch_wq)
+		destroy_workqueue(sbi->ll_dir_prefetch_wq);
+	ll_ra_cpts_fini(&sbi->ll_ra_info);
 out_pcc:
 	pcc_super_fini(&sbi->ll_pcc_super);
 out_sbi:
@@ -226,8 +297,9 @@ static void ll_free_sbi(struct super_block *sb)
 	if (sbi != NULL) {
 		if (!list_empty(&sbi->ll_squash.rsi_nosquash_nids))
 			cfs_free_nidlist(&sbi->ll_squash.rsi_nosquash_nids);
-		if (sbi->ll_ra_info.ll_readahead_wq)
-			destroy_workqueue(sbi->ll_ra_info.ll_readahead_wq);
+		if (sbi->ll_dir_prefetch_wq)
+			destroy_workqueue(sbi->ll_dir_prefetch_wq);
+		ll_ra_cpts_fini(&sbi->ll_ra_info);
 		if (sbi->ll_cache != NULL) {
 			cl_cache_decref(sbi->ll_cache);
 			sbi->ll_cache = NULL;
@@ -933,6 +1005,9 @@ void ll_kill_super(struct super_block *sb)
 		while (atomic_read(&sbi->ll_sa_running) > 0)
 			schedule_timeout_uninterruptible(
 				cfs_time_seconds(1) >> 3);
+
+		/* readdir prefetch holds directory inodes */
+		flush_workqueue(sbi->ll_dir_prefetch_wq);
 	}
 
 	EXIT;
@@ -982,6 +1057,12 @@ static const match_table_t ll_sbi_flags_name = {
 	{LL_SBI_FILE_HEAT,		"file_heat"},
 	{LL_SBI_PARALLEL_DIO,		"parallel_dio"},
 	{LL_SBI_ENCRYPT_NAME,		"name_encrypt"},
+	{LL_SBI_UNALIGNED_DIO,		"unaligned_dio"},
+	{LL_SBI_HYBRID_IO,		"hybrid_io"},
+	{LL_SBI_STATAHEAD_FNAME,	"statahead_fname"},
+	{LL_SBI_DIR_LEASE,		"dir_lease"},
+	{LL_SBI_FAULT_AROUND,		"fault_around"},
+	{LL_SBI_ZEROCOPY_WRITE,		"zerocopy_write"},
 };
 
 int ll_sbi_flags_seq_show(struct seq_file *m, void *v)
@@ -1213,6 +1294,11 @@ void ll_lli_init(struct ll_inode_info *lli)
 		spin_lock_init(&lli->lli_sa_lock);
 		lli->lli_opendir_pid = 0;
 		lli->lli_sa_enabled = 0;
+		lli->lli_sa_fname_index = 0;
+		lli->lli_sa_fname_hash = 0;
+		lli->lli_sa_fname_count = 0;
+		lli->lli_dir_prefetch_hash = 0;
+		lli->lli_dir_prefetch_trigger = 0;
 		init_rwsem(&lli->lli_lsm_sem);
 	} else {
 		mutex_init(&lli->lli_size_mutex);
@@ -1225,6 +1311,7 @@ void ll_lli_init(struct ll_inode_info *lli)
 		INIT_LIST_HEAD(&lli->lli_agl_list);
 		lli->lli_agl_index = 0;
 		lli->lli_async_rc = 0;
+		atomic_set(&lli->lli_ra_discarded, 0);
 		spin_lock_init(&lli->lli_heat_lock);
 		obd_heat_clear(lli->lli_heat_instances, OBD_HEAT_COUNT);
 		lli->lli_heat_flags = 0;
@@ -336,8 +336,11 @@ static vm_fault_t ll_fault0(struct vm_area_struct *vma, struct vm_fault *vmf)
 		 *   lock. We will try slow path to avoid loops.
 		 * - Otherwise, it should try normal fault under DLM lock. */
 		if (!(fault_ret & VM_FAULT_RETRY) &&
-		    !(fault_ret & VM_FAULT_ERROR))
+		    !(fault_ret & VM_FAULT_ERROR)) {
+			ll_stats_ops_tally(ll_i2sbi(inode),
+					   LPROC_LL_FAULT_FAST, 1);
 			GOTO(out, result = 0);
+		}
 
 		fault_ret = 0;
 	}
@@ -467,6 +470,63 @@ out:
 }
 
 #ifdef HAVE_VM_OPS_USE_VM_FAULT_ONLY
+/**
+ * Lustre implementation of a vm_operations_struct::map_pages() method, called
+ * by VM before ->fault() to map pages around the faulting address which are
+ * already cached and uptodate, without taking a fault for each of them.
+ *
+ * This relies on the same invariant as the fast_read path: an uptodate page
+ * in the page cache is covered by a DLM lock, and it is unmapped and marked
+ * !uptodate under the page lock before the lock is cancelled or the page is
+ * deleted from Lustre (see vvp_page_delete()), so filemap_map_pages() will
+ * skip it.  Pages not mapped here are left to ll_fault(), which does all the
+ * checks needed to read them.
+ *
+ * \param vmf		fault being handled
+ * \param start_pgoff	first page index to map
+ * \param end_pgoff	last page index to map
+ */
+#ifdef HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
+static vm_fault_t ll_map_pages(struct vm_fault *vmf, pgoff_t start_pgoff,
+			       pgoff_t end_pgoff)
+#else
+static void ll_map_pages(struct vm_fault *vmf, pgoff_t start_pgoff,
+			 pgoff_t end_pgoff)
+#endif
+{
+	struct file *file = vmf->vma->vm_file;
+	struct ll_file_data *fd = file->private_data;
+	struct ll_sb_info *sbi = ll_i2sbi(file_inode(file));
+#ifdef HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
+	vm_fault_t ret;
+#endif
+
+	/* PCC-attached files are read from the PCC copy in ->fault() */
+	if (!test_bit(LL_SBI_FAULT_AROUND, sbi->ll_flags) ||
+	    !ll_sbi_has_fast_read(sbi) || fd->fd_pcc_file.pccf_file)
+#ifdef HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
+		return 0;
+#else
+		return;
+#endif
+
+	CDEBUG(D_MMAP, DFID": map pages %lu-%lu for fault at %lu\n",
+	       PFID(&ll_i2info(file_inode(file))->lli_fid), start_pgoff,
+	       end_pgoff, vmf->pgoff);
+
+#ifdef HAVE_VM_OPS_MAP_PAGES_VM_FAULT_T
+	ret = filemap_map_pages(vmf, start_pgoff, end_pgoff);
+	/* the faulting page was mapped as well, ->fault() is skipped */
+	if (ret & VM_FAULT_NOPAGE)
+		ll_stats_ops_tally(sbi, LPROC_LL_FAULT_AROUND, 1);
+
+	return ret;
+#else
+	filemap_map_pages(vmf, start_pgoff, end_pgoff);
+	ll_stats_ops_tally(sbi, LPROC_LL_FAULT_AROUND, 1);
+#endif
+}
+
 static vm_fault_t ll_page_mkwrite(struct vm_fault *vmf)
 {
 	struct vm_area_struct *vma = vmf->vma;
@@ -574,6 +634,9 @@ static void ll_vm_close(struct vm_area_struct *vma)
 
 static const struct vm_operations_struct ll_file_vm_ops = {
 	.fault			= ll_fault,
+#ifdef HAVE_VM_OPS_USE_VM_FAULT_ONLY
+	.map_pages		= ll_map_pages,
+#endif
 	.page_mkwrite		= ll_page_mkwrite,
 	.open			= ll_vm_open,
 	.close			= ll_vm_close,
@@ -326,6 +326,57 @@ static int ll_site_stats_seq_show(struct seq_file *m, void *v)
 
 LDEBUGFS_SEQ_FOPS_RO(ll_site_stats);
 
+static int ll_io_stage_latency_seq_show(struct seq_file *m, void *v)
+{
+	struct super_block *sb = m->private;
+	struct cl_site *site = lu2cl_site(ll_s2sbi(sb)->ll_site);
+	unsigned long tot[CL_IO_STAGE_NR];
+	unsigned long cum[CL_IO_STAGE_NR] = { 0 };
+	unsigned long count;
+	bool done;
+	int i, j;
+
+	for (i = 0; i < CL_IO_STAGE_NR; i++)
+		tot[i] = lprocfs_oh_sum_pcpu(&site->cs_io_hist[i]);
+
+	seq_puts(m, "usecs            iter_init       lock");
+	seq_puts(m, "      start        end\n");
+	for (j = 0; j < OBD_HIST_MAX; j++) {
+		seq_printf(m, "%lu:\t\t", 1UL << j);
+		done = true;
+		for (i = 0; i < CL_IO_STAGE_NR; i++) {
+			count = lprocfs_oh_counter_pcpu(&site->cs_io_hist[i],
+							j);
+			cum[i] += count;
+			seq_printf(m, " %10lu", count);
+			if (cum[i] < tot[i])
+				done = false;
+		}
+		seq_putc(m, '\n');
+		if (done)
+			break;
+	}
+
+	return 0;
+}
+
+static ssize_t ll_io_stage_latency_seq_write(struct file *file,
+					     const char __user *buffer,
+					     size_t count, loff_t *off)
+{
+	struct seq_file *seq = file->private_data;
+	struct ll_sb_info *sbi = ll_s2sbi(seq->private);
+	struct cl_site *site = lu2cl_site(sbi->ll_site);
+	int i;
+
+	for (i = 0; i < CL_IO_STAGE_NR; i++)
+		lprocfs_oh_clear_pcpu(&site->cs_io_hist[i]);
+
+	return count;
+}
+
+LDEBUGFS_SEQ_FOPS(ll_io_stage_latency);
+
 static ssize_t max_read_ahead_mb_show(struct kobject *kobj,
 				      struct attribute *attr, char *buf)
 {
@@ -792,6 +843,42 @@ static ssize_t statahead_max_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(statahead_max);
 
+static ssize_t readdir_prefetch_pages_show(struct kobject *kobj,
+					   struct attribute *attr,
+					   char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return sprintf(buf, "%u\n", sbi->ll_dir_prefetch_pages);
+}
+
+static ssize_t readdir_prefetch_pages_store(struct kobject *kobj,
+					    struct attribute *attr,
+					    const char *buffer,
+					    size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	unsigned long val;
+	int rc;
+
+	rc = kstrtoul(buffer, 0, &val);
+	if (rc)
+		return rc;
+
+	if (val > LL_DIR_PREFETCH_MAX) {
+		CERROR("Bad readdir_prefetch_pages value %lu. Valid values are in the range [0, %d]\n",
+		       val, LL_DIR_PREFETCH_MAX);
+		return -ERANGE;
+	}
+
+	sbi->ll_dir_prefetch_pages = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(readdir_prefetch_pages);
+
 static ssize_t statahead_agl_show(struct kobject *kobj,
 				  struct attribute *attr,
 				  char *buf)
@@ -826,6 +913,40 @@ static ssize_t statahead_agl_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(statahead_agl);
 
+static ssize_t statahead_fname_show(struct kobject *kobj,
+				    struct attribute *attr,
+				    char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+			 test_bit(LL_SBI_STATAHEAD_FNAME, sbi->ll_flags));
+}
+
+static ssize_t statahead_fname_store(struct kobject *kobj,
+				     struct attribute *attr,
+				     const char *buffer,
+				     size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	if (val)
+		set_bit(LL_SBI_STATAHEAD_FNAME, sbi->ll_flags);
+	else
+		clear_bit(LL_SBI_STATAHEAD_FNAME, sbi->ll_flags);
+
+	return count;
+}
+LUSTRE_RW_ATTR(statahead_fname);
+
 static int ll_statahead_stats_seq_show(struct seq_file *m, void *v)
 {
 	struct super_block *sb = m->private;
@@ -842,6 +963,136 @@ static int ll_statahead_stats_seq_show(struct seq_file *m, void *v)
 
 LDEBUGFS_SEQ_FOPS_RO(ll_statahead_stats);
 
+static ssize_t dir_lease_show(struct kobject *kobj, struct attribute *attr,
+			      char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+			 test_bit(LL_SBI_DIR_LEASE, sbi->ll_flags));
+}
+
+static ssize_t dir_lease_store(struct kobject *kobj, struct attribute *attr,
+			       const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	if (val)
+		set_bit(LL_SBI_DIR_LEASE, sbi->ll_flags);
+	else
+		clear_bit(LL_SBI_DIR_LEASE, sbi->ll_flags);
+
+	return count;
+}
+LUSTRE_RW_ATTR(dir_lease);
+
+static int ll_dir_lease_stats_seq_show(struct seq_file *m, void *v)
+{
+	struct super_block *sb = m->private;
+	struct ll_sb_info *sbi = ll_s2sbi(sb);
+
+	seq_printf(m, "negative hits: %u\n"
+		      "negative misses: %u\n"
+		      "dir leases: %u\n",
+		   atomic_read(&sbi->ll_neg_hit),
+		   atomic_read(&sbi->ll_neg_miss),
+		   atomic_read(&sbi->ll_dir_lease));
+	return 0;
+}
+
+static ssize_t ll_dir_lease_stats_seq_write(struct file *file,
+					    const char __user *buffer,
+					    size_t count, loff_t *off)
+{
+	struct seq_file *seq = file->private_data;
+	struct ll_sb_info *sbi = ll_s2sbi(seq->private);
+
+	atomic_set(&sbi->ll_neg_hit, 0);
+	atomic_set(&sbi->ll_neg_miss, 0);
+	atomic_set(&sbi->ll_dir_lease, 0);
+
+	return count;
+}
+
+LDEBUGFS_SEQ_FOPS(ll_dir_lease_stats);
+
+static int ll_ra_async_stats_seq_show(struct seq_file *m, void *v)
+{
+	struct super_block *sb = m->private;
+	struct ll_ra_info *ra = &ll_s2sbi(sb)->ll_ra_info;
+	unsigned long wait[OBD_HIST_MAX] = { 0 };
+	unsigned long run[OBD_HIST_MAX] = { 0 };
+	unsigned long wait_tot = 0, run_tot = 0;
+	unsigned long wait_cum = 0, run_cum = 0;
+	int i, j;
+
+	seq_puts(m, "cpt   inflight     queued redirected\n");
+	for (i = 0; i < ra->ra_cpt_count; i++) {
+		struct ll_ra_cpt *rac = &ra->ra_cpts[i];
+
+		seq_printf(m, "%-3d %10d %10d %10d\n", i,
+			   atomic_read(&rac->rac_inflight),
+			   atomic_read(&rac->rac_queued),
+			   atomic_read(&rac->rac_redirected));
+		for (j = 0; j < OBD_HIST_MAX; j++) {
+			wait[j] += rac->rac_wait_hist.oh_buckets[j];
+			run[j] += rac->rac_run_hist.oh_buckets[j];
+		}
+	}
+
+	for (j = 0; j < OBD_HIST_MAX; j++) {
+		wait_tot += wait[j];
+		run_tot += run[j];
+	}
+
+	seq_puts(m, "\n\t\t\twait\t\t\trun\n");
+	seq_puts(m, "usecs                works   % cum % |");
+	seq_puts(m, "      works   % cum %\n");
+	for (j = 0; j < OBD_HIST_MAX; j++) {
+		wait_cum += wait[j];
+		run_cum += run[j];
+		seq_printf(m, "%lu:\t\t%10lu %3u %3u   | %10lu %3u %3u\n",
+			   1UL << j,
+			   wait[j], pct(wait[j], wait_tot),
+			   pct(wait_cum, wait_tot), run[j],
+			   pct(run[j], run_tot), pct(run_cum, run_tot));
+		if (wait_cum == wait_tot && run_cum == run_tot)
+			break;
+	}
+
+	return 0;
+}
+
+static ssize_t ll_ra_async_stats_seq_write(struct file *file,
+					   const char __user *buffer,
+					   size_t count, loff_t *off)
+{
+	struct seq_file *seq = file->private_data;
+	struct ll_ra_info *ra = &ll_s2sbi(seq->private)->ll_ra_info;
+	int i;
+
+	for (i = 0; i < ra->ra_cpt_count; i++) {
+		struct ll_ra_cpt *rac = &ra->ra_cpts[i];
+
+		atomic_set(&rac->rac_queued, 0);
+		atomic_set(&rac->rac_redirected, 0);
+		lprocfs_oh_clear(&rac->rac_wait_hist);
+		lprocfs_oh_clear(&rac->rac_run_hist);
+	}
+
+	return count;
+}
+
+LDEBUGFS_SEQ_FOPS(ll_ra_async_stats);
+
 static ssize_t lazystatfs_show(struct kobject *kobj,
 			       struct attribute *attr,
 			       char *buf)
@@ -1103,6 +1354,271 @@ static ssize_t parallel_dio_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(parallel_dio);
 
+static ssize_t unaligned_dio_show(struct kobject *kobj,
+				  struct attribute *attr,
+				  char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return snprintf(buf, PAGE_SIZE, "%u\n",
+			test_bit(LL_SBI_UNALIGNED_DIO, sbi->ll_flags));
+}
+
+static ssize_t unaligned_dio_store(struct kobject *kobj,
+				   struct attribute *attr,
+				   const char *buffer,
+				   size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	spin_lock(&sbi->ll_lock);
+	if (val)
+		set_bit(LL_SBI_UNALIGNED_DIO, sbi->ll_flags);
+	else
+		clear_bit(LL_SBI_UNALIGNED_DIO, sbi->ll_flags);
+	spin_unlock(&sbi->ll_lock);
+
+	return count;
+}
+LUSTRE_RW_ATTR(unaligned_dio);
+
+static ssize_t hybrid_io_show(struct kobject *kobj, struct attribute *attr,
+			      char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return snprintf(buf, PAGE_SIZE, "%u\n",
+			test_bit(LL_SBI_HYBRID_IO, sbi->ll_flags));
+}
+
+static ssize_t hybrid_io_store(struct kobject *kobj, struct attribute *attr,
+			       const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	spin_lock(&sbi->ll_lock);
+	if (val)
+		set_bit(LL_SBI_HYBRID_IO, sbi->ll_flags);
+	else
+		clear_bit(LL_SBI_HYBRID_IO, sbi->ll_flags);
+	spin_unlock(&sbi->ll_lock);
+
+	return count;
+}
+LUSTRE_RW_ATTR(hybrid_io);
+
+static ssize_t hybrid_io_threshold_store(struct ll_sb_info *sbi,
+					 size_t *threshold,
+					 const char *buffer, size_t count)
+{
+	u64 val;
+	int rc;
+
+	rc = sysfs_memparse(buffer, count, &val, "B");
+	if (rc)
+		return rc;
+
+	/* at least one full page has to be left for DIO */
+	if (val < PAGE_SIZE || val > MAX_LFS_FILESIZE)
+		return -ERANGE;
+
+	spin_lock(&sbi->ll_lock);
+	*threshold = val;
+	spin_unlock(&sbi->ll_lock);
+
+	return count;
+}
+
+static ssize_t hybrid_io_read_threshold_bytes_show(struct kobject *kobj,
+						   struct attribute *attr,
+						   char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%zu\n",
+			 sbi->ll_hybrid_io_read_threshold_bytes);
+}
+
+static ssize_t hybrid_io_read_threshold_bytes_store(struct kobject *kobj,
+						    struct attribute *attr,
+						    const char *buffer,
+						    size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return hybrid_io_threshold_store(sbi,
+					 &sbi->ll_hybrid_io_read_threshold_bytes,
+					 buffer, count);
+}
+LUSTRE_RW_ATTR(hybrid_io_read_threshold_bytes);
+
+static ssize_t hybrid_io_write_threshold_bytes_show(struct kobject *kobj,
+						    struct attribute *attr,
+						    char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%zu\n",
+			 sbi->ll_hybrid_io_write_threshold_bytes);
+}
+
+static ssize_t hybrid_io_write_threshold_bytes_store(struct kobject *kobj,
+						     struct attribute *attr,
+						     const char *buffer,
+						     size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return hybrid_io_threshold_store(sbi,
+					 &sbi->ll_hybrid_io_write_threshold_bytes,
+					 buffer, count);
+}
+LUSTRE_RW_ATTR(hybrid_io_write_threshold_bytes);
+
+static ssize_t hybrid_io_lru_pct_show(struct kobject *kobj,
+				      struct attribute *attr, char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", sbi->ll_hybrid_io_lru_pct);
+}
+
+static ssize_t hybrid_io_lru_pct_store(struct kobject *kobj,
+				       struct attribute *attr,
+				       const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	unsigned int val;
+	int rc;
+
+	rc = kstrtouint(buffer, 10, &val);
+	if (rc)
+		return rc;
+	if (val > 100)
+		return -ERANGE;
+
+	sbi->ll_hybrid_io_lru_pct = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(hybrid_io_lru_pct);
+
+static ssize_t zerocopy_write_show(struct kobject *kobj,
+				   struct attribute *attr, char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+			 test_bit(LL_SBI_ZEROCOPY_WRITE, sbi->ll_flags));
+}
+
+static ssize_t zerocopy_write_store(struct kobject *kobj,
+				    struct attribute *attr,
+				    const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	if (val)
+		set_bit(LL_SBI_ZEROCOPY_WRITE, sbi->ll_flags);
+	else
+		clear_bit(LL_SBI_ZEROCOPY_WRITE, sbi->ll_flags);
+
+	return count;
+}
+LUSTRE_RW_ATTR(zerocopy_write);
+
+static ssize_t write_lockahead_count_show(struct kobject *kobj,
+					  struct attribute *attr, char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+			 sbi->ll_write_lockahead_count);
+}
+
+static ssize_t write_lockahead_count_store(struct kobject *kobj,
+					   struct attribute *attr,
+					   const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	unsigned int val;
+	int rc;
+
+	rc = kstrtouint(buffer, 10, &val);
+	if (rc)
+		return rc;
+	if (val > SBI_MAX_WRITE_LOCKAHEAD_COUNT)
+		return -ERANGE;
+
+	sbi->ll_write_lockahead_count = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(write_lockahead_count);
+
+static ssize_t io_lock_prefetch_bytes_show(struct kobject *kobj,
+					   struct attribute *attr, char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%zu\n",
+			 sbi->ll_io_lock_prefetch_bytes);
+}
+
+static ssize_t io_lock_prefetch_bytes_store(struct kobject *kobj,
+					    struct attribute *attr,
+					    const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	u64 val;
+	int rc;
+
+	rc = sysfs_memparse(buffer, count, &val, "B");
+	if (rc)
+		return rc;
+	if (val > MAX_LFS_FILESIZE)
+		return -ERANGE;
+
+	sbi->ll_io_lock_prefetch_bytes = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(io_lock_prefetch_bytes);
+
 static ssize_t max_read_ahead_async_active_show(struct kobject *kobj,
 					       struct attribute *attr,
 					       char *buf)
@@ -1234,6 +1750,69 @@ out:
 }
 LUSTRE_RW_ATTR(read_ahead_range_kb);
 
+static ssize_t read_ahead_feedback_ms_show(struct kobject *kobj,
+					   struct attribute *attr, char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return snprintf(buf, PAGE_SIZE, "%u\n",
+			sbi->ll_ra_info.ra_feedback_ms);
+}
+
+static ssize_t read_ahead_feedback_ms_store(struct kobject *kobj,
+					    struct attribute *attr,
+					    const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	unsigned int val;
+	int rc;
+
+	rc = kstrtouint(buffer, 0, &val);
+	if (rc)
+		return rc;
+
+	if (val > RA_FEEDBACK_MS_MAX)
+		return -ERANGE;
+
+	sbi->ll_ra_info.ra_feedback_ms = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(read_ahead_feedback_ms);
+
+static ssize_t read_ahead_streams_show(struct kobject *kobj,
+				       struct attribute *attr, char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return snprintf(buf, PAGE_SIZE, "%u\n", sbi->ll_ra_info.ra_streams);
+}
+
+static ssize_t read_ahead_streams_store(struct kobject *kobj,
+					struct attribute *attr,
+					const char *buffer, size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	unsigned int val;
+	int rc;
+
+	rc = kstrtouint(buffer, 0, &val);
+	if (rc)
+		return rc;
+
+	if (val < 1 || val > LL_RA_STREAMS_MAX)
+		return -ERANGE;
+
+	sbi->ll_ra_info.ra_streams = val;
+
+	return count;
+}
+LUSTRE_RW_ATTR(read_ahead_streams);
+
 static ssize_t fast_read_show(struct kobject *kobj,
 			      struct attribute *attr,
 			      char *buf)
@@ -1270,6 +1849,40 @@ static ssize_t fast_read_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(fast_read);
 
+static ssize_t fault_around_show(struct kobject *kobj,
+				 struct attribute *attr,
+				 char *buf)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n",
+			 test_bit(LL_SBI_FAULT_AROUND, sbi->ll_flags));
+}
+
+static ssize_t fault_around_store(struct kobject *kobj,
+				  struct attribute *attr,
+				  const char *buffer,
+				  size_t count)
+{
+	struct ll_sb_info *sbi = container_of(kobj, struct ll_sb_info,
+					      ll_kset.kobj);
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	if (val)
+		set_bit(LL_SBI_FAULT_AROUND, sbi->ll_flags);
+	else
+		clear_bit(LL_SBI_FAULT_AROUND, sbi->ll_flags);
+
+	return count;
+}
+LUSTRE_RW_ATTR(fault_around);
+
 static ssize_t file_heat_show(struct kobject *kobj,
 			      struct attribute *attr,
 			      char *buf)
@@ -1725,10 +2338,16 @@ LDEBUGFS_SEQ_FOPS(ll_pcc);
 struct ldebugfs_vars lprocfs_llite_obd_vars[] = {
 	{ .name	=	"site",
 	  .fops	=	&ll_site_stats_fops			},
+	{ .name	=	"io_stage_latency",
+	  .fops	=	&ll_io_stage_latency_fops		},
 	{ .name	=	"max_cached_mb",
 	  .fops	=	&ll_max_cached_mb_fops			},
 	{ .name	=	"statahead_stats",
 	  .fops	=	&ll_statahead_stats_fops		},
+	{ .name	=	"read_ahead_async_stats",
+	  .fops	=	&ll_ra_async_stats_fops			},
+	{ .name	=	"dir_lease_stats",
+	  .fops	=	&ll_dir_lease_stats_fops		},
 	{ .name	=	"unstable_stats",
 	  .fops	=	&ll_unstable_stats_fops			},
 	{ .name =	"sbi_flags",
@@ -1773,20 +2392,34 @@ static struct attribute *llite_attrs[] = {
 	&lustre_attr_max_read_ahead_async_active.attr,
 	&lustre_attr_read_ahead_async_file_threshold_mb.attr,
 	&lustre_attr_read_ahead_range_kb.attr,
+	&lustre_attr_read_ahead_feedback_ms.attr,
+	&lustre_attr_read_ahead_streams.attr,
 	&lustre_attr_stats_track_pid.attr,
 	&lustre_attr_stats_track_ppid.attr,
 	&lustre_attr_stats_track_gid.attr,
 	&lustre_attr_statahead_running_max.attr,
 	&lustre_attr_statahead_max.attr,
+	&lustre_attr_readdir_prefetch_pages.attr,
 	&lustre_attr_statahead_agl.attr,
+	&lustre_attr_statahead_fname.attr,
+	&lustre_attr_dir_lease.attr,
 	&lustre_attr_lazystatfs.attr,
 	&lustre_attr_statfs_max_age.attr,
 	&lustre_attr_max_easize.attr,
 	&lustre_attr_default_easize.attr,
 	&lustre_attr_xattr_cache.attr,
 	&lustre_attr_fast_read.attr,
+	&lustre_attr_fault_around.attr,
 	&lustre_attr_tiny_write.attr,
 	&lustre_attr_parallel_dio.attr,
+	&lustre_attr_unaligned_dio.attr,
+	&lustre_attr_hybrid_io.attr,
+	&lustre_attr_hybrid_io_read_threshold_bytes.attr,
+	&lustre_attr_hybrid_io_write_threshold_bytes.attr,
+	&lustre_attr_hybrid_io_lru_pct.attr,
+	&lustre_attr_zerocopy_write.attr,
+	&lustre_attr_write_lockahead_count.attr,
+	&lustre_attr_io_lock_prefetch_bytes.attr,
 	&lustre_attr_file_heat.attr,
 	&lustre_attr_heat_decay_percentage.attr,
 	&lustre_attr_heat_period_second.attr,
@@ -1826,14 +2459,25 @@ static const struct llite_file_opcode {
 	{ LPROC_LL_RELEASE,	LPROCFS_TYPE_LATENCY,	"close" },
 	{ LPROC_LL_MMAP,	LPROCFS_TYPE_LATENCY,	"mmap" },
 	{ LPROC_LL_FAULT,	LPROCFS_TYPE_LATENCY,	"page_fault" },
+	{ LPROC_LL_FAULT_FAST,	LPROCFS_TYPE_REQS,	"page_fault_fast" },
+	{ LPROC_LL_FAULT_AROUND, LPROCFS_TYPE_REQS,	"page_fault_around" },
 	{ LPROC_LL_MKWRITE,	LPROCFS_TYPE_LATENCY,	"page_mkwrite" },
 	{ LPROC_LL_LLSEEK,	LPROCFS_TYPE_LATENCY,	"seek" },
 	{ LPROC_LL_FSYNC,	LPROCFS_TYPE_LATENCY,	"fsync" },
 	{ LPROC_LL_READDIR,	LPROCFS_TYPE_LATENCY,	"readdir" },
+	{ LPROC_LL_READDIR_PREFETCH, LPROCFS_TYPE_REQS,	"readdir_prefetch" },
 	{ LPROC_LL_INODE_OCOUNT,LPROCFS_TYPE_REQS |
 				LPROCFS_CNTR_AVGMINMAX |
 				LPROCFS_CNTR_STDDEV,	"opencount" },
 	{ LPROC_LL_INODE_OPCLTM,LPROCFS_TYPE_LATENCY,	"openclosetime" },
+	{ LPROC_LL_HYBRID_READ_BYTES, LPROCFS_TYPE_BYTES_FULL,
+						"hybrid_read_bytes" },
+	{ LPROC_LL_HYBRID_WRITE_BYTES, LPROCFS_TYPE_BYTES_FULL,
+						"hybrid_write_bytes" },
+	{ LPROC_LL_ZEROCOPY_WRITE_BYTES, LPROCFS_TYPE_BYTES_FULL,
+						"zerocopy_write_bytes" },
+	{ LPROC_LL_WRITE_LOCKAHEAD, LPROCFS_TYPE_REQS,	"write_lockahead" },
+	{ LPROC_LL_IO_LOCK_PREFETCH, LPROCFS_TYPE_REQS,	"io_lock_prefetch" },
 	/* inode operation */
 	{ LPROC_LL_SETATTR,	LPROCFS_TYPE_LATENCY,	"setattr" },
 	{ LPROC_LL_TRUNC,	LPROCFS_TYPE_LATENCY,	"truncate" },
@@ -1854,6 +2498,8 @@ static const struct llite_file_opcode {
 	{ LPROC_LL_SETXATTR,	LPROCFS_TYPE_LATENCY,	"setxattr" },
 	{ LPROC_LL_GETXATTR,	LPROCFS_TYPE_LATENCY,	"getxattr" },
 	{ LPROC_LL_GETXATTR_HITS, LPROCFS_TYPE_REQS,	"getxattr_hits" },
+	{ LPROC_LL_GETXATTR_REVALIDATED, LPROCFS_TYPE_REQS,
+						"getxattr_revalidated" },
 	{ LPROC_LL_LISTXATTR,	LPROCFS_TYPE_LATENCY,	"listxattr" },
 	{ LPROC_LL_REMOVEXATTR,	LPROCFS_TYPE_LATENCY,	"removexattr" },
 	{ LPROC_LL_INODE_PERM,	LPROCFS_TYPE_LATENCY,	"inode_permission" },
@@ -1896,6 +2542,9 @@ static const char *const ra_stat_string[] = {
 	[RA_STAT_ASYNC]			= "async_readahead",
 	[RA_STAT_FAILED_FAST_READ]	= "failed_to_fast_read",
 	[RA_STAT_MMAP_RANGE_READ]	= "mmap_range_read",
+	[RA_STAT_FEEDBACK_RAMP_UP]	= "feedback_ramp_up",
+	[RA_STAT_FEEDBACK_THROTTLE]	= "feedback_throttle",
+	[RA_STAT_NEW_STREAM]		= "new_stream",
 };
 
 int ll_debugfs_register_super(struct super_block *sb, const char *name)
@@ -337,6 +337,7 @@ static void ll_lock_cancel_bits(struct ldlm_lock *lock, __u64 to_cancel)
 		       "pfid  = "DFID"\n", PFID(ll_inode2fid(inode)),
 		       lli, PFID(&lli->lli_pfid));
 		truncate_inode_pages(inode->i_mapping, 0);
+		ll_dir_prefetch_reset(inode);
 
 		if (unlikely(!fid_is_zero(&lli->lli_pfid))) {
 			struct inode *master_inode = NULL;
@@ -649,12 +650,199 @@ struct dentry *ll_splice_alias(struct inode *inode, struct dentry *de)
         return de;
 }
 
+/* largest directory whose pages are scanned for dir_lease lookups */
+#define LL_DIR_LEASE_MAX_PAGES	64
+
+/*
+ * With dir_lease, look @dentry up in the cached pages of directory @dir,
+ * while the directory lock taken by ll_dir_lease_get() is held, so that
+ * names which don't exist are answered without asking the MDT. Only pages
+ * already in the page cache are scanned, if one is missing the name is
+ * looked up on the MDT as usual.
+ *
+ * \retval	1 if the name doesn't exist, @dentry is added as negative
+ * \retval	0 if it may exist, or the directory can't tell
+ */
+static int ll_dir_lease_lookup(struct inode *dir, struct dentry *dentry)
+{
+	struct lookup_intent it = { .it_op = IT_READDIR };
+	struct ll_sb_info *sbi = ll_i2sbi(dir);
+	struct md_op_data *op_data;
+	struct dentry *alias;
+	__u64 pos = 0;
+	int pages = 0;
+	int rc = 1;
+
+	ENTRY;
+
+	if (!test_bit(LL_SBI_DIR_LEASE, sbi->ll_flags) ||
+	    ll_dir_striped(dir) || IS_ENCRYPTED(dir))
+		RETURN(0);
+
+	/* the reference keeps the lock from being cancelled meanwhile */
+	if (!md_revalidate_lock(ll_i2mdexp(dir), &it, ll_inode2fid(dir), NULL))
+		RETURN(0);
+
+	op_data = ll_prep_md_op_data(NULL, dir, dir, NULL, 0, 0,
+				     LUSTRE_OPC_ANY, dir);
+	if (IS_ERR(op_data))
+		GOTO(out_release, rc = 0);
+
+	while (pos != MDS_DIR_END_OFF && rc == 1) {
+		struct lu_dirpage *dp;
+		struct lu_dirent *ent;
+		struct page *page;
+
+		if (++pages > LL_DIR_LEASE_MAX_PAGES) {
+			rc = 0;
+			break;
+		}
+
+		page = ll_get_cached_dir_page(dir, op_data, pos);
+		if (IS_ERR(page)) {
+			rc = 0;
+			break;
+		}
+
+		dp = page_address(page);
+		for (ent = lu_dirent_start(dp); ent != NULL;
+		     ent = lu_dirent_next(ent)) {
+			if (le16_to_cpu(ent->lde_namelen) ==
+			    dentry->d_name.len &&
+			    !memcmp(ent->lde_name, dentry->d_name.name,
+				    dentry->d_name.len)) {
+				rc = 0;
+				break;
+			}
+		}
+
+		pos = le64_to_cpu(dp->ldp_hash_end);
+		ll_release_page(dir, page,
+				le32_to_cpu(dp->ldp_flags) & LDF_COLLIDE);
+	}
+	ll_finish_md_op_data(op_data);
+
+	if (rc == 1) {
+		alias = ll_splice_alias(NULL, dentry);
+		if (IS_ERR(alias))
+			GOTO(out_release, rc = 0);
+		d_lustre_revalidate(dentry);
+		ll_d2d(dentry)->lld_dir_lease = 1;
+		atomic_inc(&sbi->ll_neg_hit);
+	}
+
+out_release:
+	ll_intent_release(&it);
+
+	RETURN(rc);
+}
+
+/*
+ * Lock the UPDATE bit of directory @parent, so that names looked up in it
+ * and found not to exist stay valid negative dentries until another client
+ * modifies the directory and the lock is revoked, see
+ * ll_prune_negative_children(), and ll_dir_lease_lookup() can tell other
+ * names don't exist.
+ */
+static void ll_dir_lease_get(struct dentry *parent)
+{
+	struct inode *dir = parent->d_inode;
+	struct lookup_intent it = { .it_op = IT_GETATTR };
+	struct ptlrpc_request *req = NULL;
+	struct md_op_data *op_data;
+	int rc;
+
+	op_data = ll_prep_md_op_data(NULL, dir, dir, NULL, 0, 0,
+				     LUSTRE_OPC_ANY, NULL);
+	if (IS_ERR(op_data))
+		return;
+
+	rc = md_intent_lock(ll_i2mdexp(dir), op_data, &it, &req,
+			    &ll_md_blocking_ast, 0);
+	ll_finish_md_op_data(op_data);
+	if (rc < 0)
+		GOTO(out, rc);
+
+	/* update dir attributes from the reply, as the lock covers them */
+	rc = ll_revalidate_it_finish(req, &it, parent);
+	if (rc == 0)
+		atomic_inc(&ll_i2sbi(dir)->ll_dir_lease);
+	ll_intent_release(&it);
+out:
+	ptlrpc_req_finished(req);
+}
+
+struct ll_dir_lease_work {
+	struct work_struct	ldlw_work;
+	struct dentry		*ldlw_parent;
+};
+
+static void ll_dir_lease_handle_work(struct work_struct *wq)
+{
+	struct ll_dir_lease_work *work;
+	struct dentry *parent;
+
+	work = container_of(wq, struct ll_dir_lease_work, ldlw_work);
+	parent = work->ldlw_parent;
+	ll_dir_lease_get(parent);
+	clear_bit(LLIF_DIR_LEASE, &ll_i2info(parent->d_inode)->lli_flags);
+	dput(parent);
+	OBD_FREE_PTR(work);
+}
+
+/*
+ * Take the dir_lease lock of @parent in the background, so that a lookup
+ * which missed doesn't wait for a second RPC. Only the lookups sent after
+ * the lock is granted profit from it, see ll_dir_lease_handle().
+ */
+static void ll_dir_lease_start(struct dentry *parent)
+{
+	struct inode *dir = parent->d_inode;
+	struct ll_inode_info *lli = ll_i2info(dir);
+	struct ll_dir_lease_work *work;
+
+	/* one lock request at a time */
+	if (test_and_set_bit(LLIF_DIR_LEASE, &lli->lli_flags))
+		return;
+
+	OBD_ALLOC_PTR(work);
+	if (!work) {
+		clear_bit(LLIF_DIR_LEASE, &lli->lli_flags);
+		return;
+	}
+
+	INIT_WORK(&work->ldlw_work, ll_dir_lease_handle_work);
+	work->ldlw_parent = dget(parent);
+	queue_work(ll_i2sbi(dir)->ll_dir_prefetch_wq, &work->ldlw_work);
+}
+
+/*
+ * Save in @lockh the dir_lease lock of @dir held before a lookup is sent to
+ * the MDT. A negative reply is known to be covered by the lock only if this
+ * lock is still granted when the reply is handled: a name created meanwhile
+ * by another client would have revoked it.
+ */
+static void ll_dir_lease_handle(struct inode *dir, struct lustre_handle *lockh)
+{
+	struct lookup_intent it = { .it_op = IT_GETATTR };
+
+	if (!test_bit(LL_SBI_DIR_LEASE, ll_i2sbi(dir)->ll_flags) ||
+	    ll_dir_striped(dir))
+		return;
+
+	if (md_revalidate_lock(ll_i2mdexp(dir), &it, ll_inode2fid(dir), NULL)) {
+		lockh->cookie = it.it_lock_handle;
+		ll_intent_release(&it);
+	}
+}
+
 static int ll_lookup_it_finish(struct ptlrpc_request *request,
 			       struct lookup_intent *it,
 			       struct inode *parent, struct dentry **de,
 			       void *secctx, __u32 secctxlen,
 			       void *encctx, __u32 encctxlen,
-			       ktime_t kstart, bool encrypt)
+			       ktime_t kstart, bool encrypt,
+			       const struct lustre_handle *lease_lockh)
 {
 	struct inode		 *inode = NULL;
 	__u64			  bits = 0;
@@ -772,6 +960,11 @@ static int ll_lookup_it_finish(struct ptlrpc_request *request,
 					.it_op = IT_GETATTR,
 					.it_lock_handle = 0 };
 		struct lu_fid	fid = ll_i2info(parent)->lli_fid;
+		struct ll_sb_info *sbi = ll_i2sbi(parent);
+		bool dir_lease = test_bit(LL_SBI_DIR_LEASE, sbi->ll_flags) &&
+				 !ll_dir_striped(parent) &&
+				 it->it_op & (IT_LOOKUP | IT_GETATTR);
+		bool lease = false;
 
 		/* If it is striped directory, get the real stripe parent */
 		if (unlikely(ll_dir_striped(parent))) {
@@ -783,11 +976,25 @@ static int ll_lookup_it_finish(struct ptlrpc_request *request,
 				GOTO(out, rc);
 		}
 
+		if (dir_lease)
+			atomic_inc(&sbi->ll_neg_miss);
+
 		if (md_revalidate_lock(ll_i2mdexp(parent), &parent_it, &fid,
 				       NULL)) {
-			d_lustre_revalidate(*de);
+			/* with dir_lease, the reply must have been sent under
+			 * this lock, or a name created by another client
+			 * before the lock was granted is cached as missing */
+			lease = dir_lease && lustre_handle_is_used(lease_lockh) &&
+				parent_it.it_lock_handle == lease_lockh->cookie;
+			if (lease || !dir_lease)
+				d_lustre_revalidate(*de);
 			ll_intent_release(&parent_it);
+		} else if (dir_lease) {
+			ll_dir_lease_start((*de)->d_parent);
 		}
+
+		if (ll_d2d(*de))
+			ll_d2d(*de)->lld_dir_lease = lease;
 	}
 
 	if (it_disposition(it, DISP_OPEN_CREATE)) {
@@ -815,6 +1022,7 @@ static struct dentry *ll_lookup_it(struct inode *parent, struct dentry *dentry,
 {
 	ktime_t kstart = ktime_get();
 	struct lookup_intent lookup_it = { .it_op = IT_LOOKUP };
+	struct lustre_handle lease_lockh = { 0 };
 	struct dentry *save = dentry, *retval;
 	struct ptlrpc_request *req = NULL;
 	struct md_op_data *op_data = NULL;
@@ -844,6 +1052,10 @@ static struct dentry *ll_lookup_it(struct inode *parent, struct dentry *dentry,
 			RETURN(dentry == save ? NULL : dentry);
 	}
 
+	if (it->it_op & (IT_LOOKUP | IT_GETATTR) &&
+	    ll_dir_lease_lookup(parent, dentry))
+		RETURN(NULL);
+
 	if (it->it_op & IT_OPEN && it->it_flags & FMODE_WRITE &&
 	    dentry->d_sb->s_flags & SB_RDONLY)
 		RETURN(ERR_PTR(-EROFS));
@@ -1009,6 +1221,9 @@ inherit:
 		it->it_flags |= MDS_OPEN_PCC;
 	}
 
+	if (it->it_op & (IT_LOOKUP | IT_GETATTR))
+		ll_dir_lease_handle(parent, &lease_lockh);
+
 	rc = md_intent_lock(ll_i2mdexp(parent), op_data, it, &req,
 			    &ll_md_blocking_ast, 0);
 	/* If the MDS allows the client to chgrp (CFS_SETGRP_PERM), but the
@@ -1055,7 +1270,7 @@ inherit:
 				 secctxlen != NULL ? *secctxlen : 0,
 				 encctx != NULL ? *encctx : NULL,
 				 encctxlen != NULL ? *encctxlen : 0,
-				 kstart, encrypt);
+				 kstart, encrypt, &lease_lockh);
 	if (rc != 0) {
 		ll_intent_release(it);
 		GOTO(out, retval = ERR_PTR(rc));
@@ -1213,6 +1428,7 @@ static int ll_atomic_open(struct inode *dir, struct dentry *dentry,
 			item.pm_projid = ll_i2info(dir)->lli_projid;
 			item.pm_name = &dentry->d_name;
 			dataset = pcc_dataset_match_get(&sbi->ll_pcc_super,
+							LU_PCC_READWRITE,
 							&item);
 			pca.pca_dataset = dataset;
 		}
@@ -82,6 +82,14 @@
  * SSDs. RO-PCC is based on the same framework as RW-PCC, expect
  * that no HSM mechanism is used.
  *
+ * A file matching the rule of a RO-PCC dataset (added with "ropcc=1" and a
+ * non-zero "roid") is copied into the dataset in the background the first
+ * time it is opened for read on the client. The copy is tagged with the data
+ * version of the Lustre file, and later read-only opens use it only while the
+ * data version is unchanged, which gives close-to-open consistency. Each
+ * dataset keeps its copies in a LRU list, the least recently used copies are
+ * removed once they take more than "ro_capacity_mb".
+ *
  * The main advantages to use this SSD cache on the Lustre clients via PCC
  * is that:
  * - The I/O stack becomes much simpler for the cached data, as there is no
@@ -112,6 +120,9 @@
 
 struct kmem_cache *pcc_inode_slab;
 
+/* Max number of files copied into RO-PCC datasets at the same time */
+#define PCC_RO_FETCH_THREADS	4
+
 int pcc_super_init(struct pcc_super *super)
 {
 	struct cred *cred;
@@ -126,6 +137,14 @@ int pcc_super_init(struct pcc_super *super)
 	INIT_LIST_HEAD(&super->pccs_datasets);
 	super->pccs_generation = 1;
 
+	super->pccs_ro_wq = cfs_cpt_bind_workqueue("ll-pcc-ro", cfs_cpt_tab,
+						   0, CFS_CPT_ANY,
+						   PCC_RO_FETCH_THREADS);
+	if (IS_ERR(super->pccs_ro_wq)) {
+		put_cred(super->pccs_cred);
+		return PTR_ERR(super->pccs_ro_wq);
+	}
+
 	return 0;
 }
 
@@ -496,6 +515,11 @@ pcc_parse_value_pair(struct pcc_cmd *cmd, char *buffer)
 			return rc;
 		if (id > 0)
 			cmd->u.pccc_add.pccc_flags |= PCC_DATASET_ROPCC;
+	} else if (strcmp(key, "ro_capacity_mb") == 0) {
+		rc = kstrtoul(val, 10, &id);
+		if (rc)
+			return rc;
+		cmd->u.pccc_add.pccc_ro_capacity = (__u64)id << 20;
 	} else {
 		return -EINVAL;
 	}
@@ -695,14 +719,22 @@ pcc_cond_match(struct pcc_match_rule *rule, struct pcc_matcher *matcher)
 }
 
 struct pcc_dataset*
-pcc_dataset_match_get(struct pcc_super *super, struct pcc_matcher *matcher)
+pcc_dataset_match_get(struct pcc_super *super, enum lu_pcc_type type,
+		      struct pcc_matcher *matcher)
 {
 	struct pcc_dataset *dataset;
 	struct pcc_dataset *selected = NULL;
 
 	down_read(&super->pccs_rw_sem);
 	list_for_each_entry(dataset, &super->pccs_datasets, pccd_linkage) {
-		if (!(dataset->pccd_flags & PCC_DATASET_RWPCC))
+		if (type == LU_PCC_READWRITE &&
+		    !(dataset->pccd_flags & PCC_DATASET_RWPCC))
+			continue;
+
+		/* RO-PCC caching needs an explicit read-only ID */
+		if (type == LU_PCC_READONLY &&
+		    (!(dataset->pccd_flags & PCC_DATASET_ROPCC) ||
+		     dataset->pccd_roid == 0))
 			continue;
 
 		if (pcc_cond_match(&dataset->pccd_rule, matcher)) {
@@ -713,7 +745,8 @@ pcc_dataset_match_get(struct pcc_super *super, struct pcc_matcher *matcher)
 	}
 	up_read(&super->pccs_rw_sem);
 	if (selected)
-		CDEBUG(D_CACHE, "PCC create, matched %s - %d:%d:%d:%s\n",
+		CDEBUG(D_CACHE, "PCC %s, matched %s - %d:%d:%d:%s\n",
+		       type == LU_PCC_READONLY ? "fetch" : "create",
 		       dataset->pccd_rule.pmr_conds_str,
 		       matcher->pm_uid, matcher->pm_gid,
 		       matcher->pm_projid, matcher->pm_name->name);
@@ -721,6 +754,20 @@ pcc_dataset_match_get(struct pcc_super *super, struct pcc_matcher *matcher)
 	return selected;
 }
 
+static const struct rhashtable_params pcc_ro_hash_params = {
+	.key_len	= sizeof(struct lu_fid),
+	.key_offset	= offsetof(struct pcc_ro_entry, pre_fid),
+	.head_offset	= offsetof(struct pcc_ro_entry, pre_hash),
+	.automatic_shrinking = true,
+};
+
+static void pcc_ro_entry_free(void *vpre, void *data)
+{
+	struct pcc_ro_entry *pre = vpre;
+
+	kfree(pre);
+}
+
 /**
  * pcc_dataset_add - Add a Cache policy to control which files need be
  * cached and where it will be cached.
@@ -741,8 +788,15 @@ pcc_dataset_add(struct pcc_super *super, struct pcc_cmd *cmd)
 	if (dataset == NULL)
 		return -ENOMEM;
 
+	rc = rhashtable_init(&dataset->pccd_ro_hash, &pcc_ro_hash_params);
+	if (rc) {
+		OBD_FREE_PTR(dataset);
+		return rc;
+	}
+
 	rc = kern_path(pathname, LOOKUP_DIRECTORY, &dataset->pccd_path);
 	if (unlikely(rc)) {
+		rhashtable_destroy(&dataset->pccd_ro_hash);
 		OBD_FREE_PTR(dataset);
 		return rc;
 	}
@@ -750,6 +804,9 @@ pcc_dataset_add(struct pcc_super *super, struct pcc_cmd *cmd)
 	dataset->pccd_rwid = cmd->u.pccc_add.pccc_rwid;
 	dataset->pccd_roid = cmd->u.pccc_add.pccc_roid;
 	dataset->pccd_flags = cmd->u.pccc_add.pccc_flags;
+	dataset->pccd_ro_capacity = cmd->u.pccc_add.pccc_ro_capacity;
+	spin_lock_init(&dataset->pccd_ro_lock);
+	INIT_LIST_HEAD(&dataset->pccd_ro_lru);
 	atomic_set(&dataset->pccd_refcount, 1);
 
 	rc = pcc_dataset_rule_init(&dataset->pccd_rule, cmd);
@@ -814,6 +871,9 @@ void
 pcc_dataset_put(struct pcc_dataset *dataset)
 {
 	if (atomic_dec_and_test(&dataset->pccd_refcount)) {
+		/* the RO-PCC copies stay in the dataset for the next mount */
+		rhashtable_free_and_destroy(&dataset->pccd_ro_hash,
+					    pcc_ro_entry_free, NULL);
 		pcc_dataset_rule_fini(&dataset->pccd_rule);
 		path_put(&dataset->pccd_path);
 		OBD_FREE_PTR(dataset);
@@ -845,10 +905,38 @@ pcc_dataset_del(struct pcc_super *super, char *pathname)
 static void
 pcc_dataset_dump(struct pcc_dataset *dataset, struct seq_file *m)
 {
+	__u64 hits = atomic64_read(&dataset->pccd_ro_hits);
+	__u64 misses = atomic64_read(&dataset->pccd_ro_misses);
+	__u64 bytes;
+
 	seq_printf(m, "%s:\n", dataset->pccd_pathname);
 	seq_printf(m, "  rwid: %u\n", dataset->pccd_rwid);
 	seq_printf(m, "  flags: %x\n", dataset->pccd_flags);
 	seq_printf(m, "  autocache: %s\n", dataset->pccd_rule.pmr_conds_str);
+	if (!(dataset->pccd_flags & PCC_DATASET_ROPCC) ||
+	    dataset->pccd_roid == 0)
+		return;
+
+	spin_lock(&dataset->pccd_ro_lock);
+	bytes = dataset->pccd_ro_bytes;
+	spin_unlock(&dataset->pccd_ro_lock);
+
+	seq_printf(m, "  roid: %u\n", dataset->pccd_roid);
+	seq_printf(m, "  ro_capacity_mb: %llu\n",
+		   dataset->pccd_ro_capacity >> 20);
+	seq_printf(m, "  ro_cached_bytes: %llu\n", bytes);
+	seq_printf(m, "  ro_hits: %llu\n", hits);
+	seq_printf(m, "  ro_misses: %llu\n", misses);
+	seq_printf(m, "  ro_hit_rate: %llu%%\n",
+		   hits + misses ? div64_u64(hits * 100, hits + misses) : 0);
+	seq_printf(m, "  ro_bytes_saved: %lld\n",
+		   atomic64_read(&dataset->pccd_ro_hit_bytes));
+	seq_printf(m, "  ro_fetches: %lld\n",
+		   atomic64_read(&dataset->pccd_ro_fetches));
+	seq_printf(m, "  ro_fetch_bytes: %lld\n",
+		   atomic64_read(&dataset->pccd_ro_fetch_bytes));
+	seq_printf(m, "  ro_evictions: %lld\n",
+		   atomic64_read(&dataset->pccd_ro_evictions));
 }
 
 int
@@ -880,6 +968,8 @@ static void pcc_remove_datasets(struct pcc_super *super)
 
 void pcc_super_fini(struct pcc_super *super)
 {
+	/* wait for the RO-PCC copies in progress, they hold datasets */
+	destroy_workqueue(super->pccs_ro_wq);
 	pcc_remove_datasets(super);
 	put_cred(super->pccs_cred);
 }
@@ -1080,6 +1170,7 @@ void pcc_file_init(struct pcc_file *pccf)
 {
 	pccf->pccf_file = NULL;
 	pccf->pccf_type = LU_PCC_NONE;
+	pccf->pccf_dataset = NULL;
 }
 
 static inline bool pcc_auto_attach_enabled(enum pcc_dataset_flags flags,
@@ -1094,6 +1185,8 @@ static inline bool pcc_auto_attach_enabled(enum pcc_dataset_flags flags,
 }
 
 static const char pcc_xattr_layout[] = XATTR_USER_PREFIX "PCC.layout";
+/* Data version of the Lustre file a RO-PCC copy was made from */
+static const char pcc_xattr_dv[] = XATTR_USER_PREFIX "PCC.dv";
 
 static int pcc_layout_xattr_set(struct pcc_inode *pcci, __u32 gen)
 {
@@ -1485,6 +1578,270 @@ static inline bool pcc_may_auto_attach(struct inode *inode,
 	return lli->lli_pcc_dsflags & PCC_DATASET_IO_ATTACH;
 }
 
+/* Unlink the RO-PCC copy @pcc_dentry, must be called with the PCC creds */
+static void pcc_ro_unlink(struct pcc_dataset *dataset,
+			  struct dentry *pcc_dentry)
+{
+	struct dentry *parent = dget_parent(pcc_dentry);
+	int rc = 0;
+
+	inode_lock_nested(parent->d_inode, I_MUTEX_PARENT);
+	if (pcc_dentry->d_parent == parent && d_is_positive(pcc_dentry))
+		rc = vfs_unlink(&init_user_ns, parent->d_inode, pcc_dentry);
+	inode_unlock(parent->d_inode);
+	dput(parent);
+
+	if (rc)
+		CWARN("%s: failed to unlink RO-PCC file %pd: rc = %d\n",
+		      dataset->pccd_pathname, pcc_dentry, rc);
+}
+
+/*
+ * Move the RO-PCC copy of @fid to the tail of the LRU list of @dataset, add
+ * it if it is not tracked yet, and remove the least recently used copies
+ * beyond the dataset capacity. Must be called with the PCC creds.
+ */
+static void pcc_ro_lru_update(struct pcc_dataset *dataset,
+			      struct lu_fid *fid, __u64 size)
+{
+	struct pcc_ro_entry *pre;
+	struct pcc_ro_entry *new = NULL;
+	struct pcc_ro_entry *tmp;
+	LIST_HEAD(victims);
+
+	spin_lock(&dataset->pccd_ro_lock);
+	pre = rhashtable_lookup_fast(&dataset->pccd_ro_hash, fid,
+				     pcc_ro_hash_params);
+	if (!pre) {
+		spin_unlock(&dataset->pccd_ro_lock);
+
+		new = kzalloc(sizeof(*new), GFP_NOFS);
+		if (!new)
+			return;
+		new->pre_fid = *fid;
+
+		spin_lock(&dataset->pccd_ro_lock);
+		pre = rhashtable_lookup_get_insert_fast(&dataset->pccd_ro_hash,
+							&new->pre_hash,
+							pcc_ro_hash_params);
+		if (IS_ERR(pre)) {
+			spin_unlock(&dataset->pccd_ro_lock);
+			kfree(new);
+			return;
+		}
+		if (!pre) {
+			pre = new;
+			new = NULL;
+			list_add_tail(&pre->pre_lru, &dataset->pccd_ro_lru);
+		}
+	}
+
+	dataset->pccd_ro_bytes += size - pre->pre_size;
+	pre->pre_size = size;
+	list_move_tail(&pre->pre_lru, &dataset->pccd_ro_lru);
+
+	while (dataset->pccd_ro_capacity &&
+	       dataset->pccd_ro_bytes > dataset->pccd_ro_capacity) {
+		tmp = list_first_entry(&dataset->pccd_ro_lru,
+				       struct pcc_ro_entry, pre_lru);
+		/* keep the copy being used even if it is too large */
+		if (tmp == pre)
+			break;
+
+		rhashtable_remove_fast(&dataset->pccd_ro_hash, &tmp->pre_hash,
+				       pcc_ro_hash_params);
+		list_move(&tmp->pre_lru, &victims);
+		dataset->pccd_ro_bytes -= tmp->pre_size;
+	}
+	spin_unlock(&dataset->pccd_ro_lock);
+	kfree(new);
+
+	list_for_each_entry_safe(pre, tmp, &victims, pre_lru) {
+		char pathname[PCC_DATASET_MAX_PATH];
+		struct dentry *pcc_dentry;
+
+		list_del(&pre->pre_lru);
+		pcc_fid2dataset_path(pathname, sizeof(pathname), &pre->pre_fid);
+		pcc_dentry = pcc_lookup(dataset->pccd_path.dentry, pathname);
+		if (!IS_ERR(pcc_dentry)) {
+			CDEBUG(D_CACHE, "%s: evict RO-PCC copy of "DFID"\n",
+			       dataset->pccd_pathname, PFID(&pre->pre_fid));
+			pcc_ro_unlink(dataset, pcc_dentry);
+			dput(pcc_dentry);
+		}
+		atomic64_inc(&dataset->pccd_ro_evictions);
+		kfree_rcu(pre, pre_rcu);
+	}
+}
+
+/* Stop tracking the RO-PCC copy of @fid, it was removed */
+static void pcc_ro_lru_del(struct pcc_dataset *dataset, struct lu_fid *fid)
+{
+	struct pcc_ro_entry *pre;
+
+	spin_lock(&dataset->pccd_ro_lock);
+	pre = rhashtable_lookup_fast(&dataset->pccd_ro_hash, fid,
+				     pcc_ro_hash_params);
+	if (pre) {
+		rhashtable_remove_fast(&dataset->pccd_ro_hash, &pre->pre_hash,
+				       pcc_ro_hash_params);
+		list_del(&pre->pre_lru);
+		dataset->pccd_ro_bytes -= pre->pre_size;
+	}
+	spin_unlock(&dataset->pccd_ro_lock);
+
+	if (pre)
+		kfree_rcu(pre, pre_rcu);
+}
+
+struct pcc_ro_fetch_work {
+	struct work_struct	 prw_work;
+	/* Lustre file to copy */
+	struct path		 prw_path;
+	struct pcc_dataset	*prw_dataset;
+};
+
+static void pcc_ro_fetch_work(struct work_struct *work);
+
+/* Queue the copy of @file into RO-PCC @dataset, unless one is in progress */
+static void pcc_ro_fetch(struct inode *inode, struct file *file,
+			 struct pcc_dataset *dataset)
+{
+	struct ll_inode_info *lli = ll_i2info(inode);
+	struct pcc_ro_fetch_work *prw;
+
+	if (dataset->pccd_ro_capacity &&
+	    i_size_read(inode) > dataset->pccd_ro_capacity)
+		return;
+
+	pcc_inode_lock(inode);
+	if (lli->lli_pcc_state & PCC_STATE_FL_ATTACHING) {
+		pcc_inode_unlock(inode);
+		return;
+	}
+	lli->lli_pcc_state |= PCC_STATE_FL_ATTACHING;
+	pcc_inode_unlock(inode);
+
+	OBD_ALLOC_PTR(prw);
+	if (!prw) {
+		pcc_inode_lock(inode);
+		lli->lli_pcc_state &= ~PCC_STATE_FL_ATTACHING;
+		pcc_inode_unlock(inode);
+		return;
+	}
+
+	INIT_WORK(&prw->prw_work, pcc_ro_fetch_work);
+	prw->prw_path = file->f_path;
+	path_get(&prw->prw_path);
+	atomic_inc(&dataset->pccd_refcount);
+	prw->prw_dataset = dataset;
+	queue_work(ll_i2pccs(inode)->pccs_ro_wq, &prw->prw_work);
+}
+
+/*
+ * Open the RO-PCC copy of the file for a read-only open if it has the same
+ * data version as the Lustre file, otherwise fetch it in the background for
+ * the next opens. Errors are ignored, the file is then read from OSTs.
+ */
+static void pcc_readonly_open(struct inode *inode, struct file *file)
+{
+	struct ll_inode_info *lli = ll_i2info(inode);
+	struct pcc_super *super = ll_i2pccs(inode);
+	struct ll_file_data *fd = file->private_data;
+	struct pcc_file *pccf = &fd->fd_pcc_file;
+	char pathname[PCC_DATASET_MAX_PATH];
+	struct pcc_dataset *dataset;
+	const struct cred *old_cred;
+	struct dentry *pcc_dentry;
+	struct pcc_matcher item;
+	struct file *pcc_file;
+	struct path path;
+	bool attaching;
+	__u64 pcc_dv;
+	__u64 dv;
+	int rc;
+
+	ENTRY;
+
+	if ((file->f_mode & (FMODE_READ | FMODE_WRITE)) != FMODE_READ)
+		RETURN_EXIT;
+
+	if (list_empty(&super->pccs_datasets) || i_size_read(inode) == 0)
+		RETURN_EXIT;
+
+	/*
+	 * The file is being fetched, possibly started after pcc_file_open()
+	 * checked, and this may be the open of pcc_ro_fetch_work() itself:
+	 * the copy is neither a hit nor a miss yet.
+	 */
+	pcc_inode_lock(inode);
+	attaching = lli->lli_pcc_state & PCC_STATE_FL_ATTACHING;
+	pcc_inode_unlock(inode);
+	if (attaching)
+		RETURN_EXIT;
+
+	item.pm_uid = from_kuid(&init_user_ns, current_uid());
+	item.pm_gid = from_kgid(&init_user_ns, current_gid());
+	item.pm_projid = lli->lli_projid;
+	item.pm_name = &file_dentry(file)->d_name;
+	dataset = pcc_dataset_match_get(super, LU_PCC_READONLY, &item);
+	if (!dataset)
+		RETURN_EXIT;
+
+	old_cred = override_creds(super->pccs_cred);
+	pcc_fid2dataset_path(pathname, sizeof(pathname), &lli->lli_fid);
+	pcc_dentry = pcc_lookup(dataset->pccd_path.dentry, pathname);
+	if (IS_ERR(pcc_dentry))
+		GOTO(out_fetch, rc = PTR_ERR(pcc_dentry));
+
+	rc = ll_vfs_getxattr(pcc_dentry, pcc_dentry->d_inode, pcc_xattr_dv,
+			     &pcc_dv, sizeof(pcc_dv));
+	if (rc == sizeof(pcc_dv))
+		rc = ll_data_version(inode, &dv, LL_DV_RD_FLUSH);
+	else if (rc >= 0)
+		rc = -ENODATA;
+	if (rc == 0 && dv != pcc_dv)
+		rc = -ESTALE;
+	if (rc) {
+		dput(pcc_dentry);
+		GOTO(out_fetch, rc);
+	}
+
+	path.mnt = dataset->pccd_path.mnt;
+	path.dentry = pcc_dentry;
+	pcc_file = dentry_open(&path, O_RDONLY | O_LARGEFILE, current_cred());
+	dput(pcc_dentry);
+	if (IS_ERR_OR_NULL(pcc_file)) {
+		rc = pcc_file == NULL ? -EINVAL : PTR_ERR(pcc_file);
+		atomic64_inc(&dataset->pccd_ro_misses);
+		GOTO(out_put, rc);
+	}
+
+	pcc_ro_lru_update(dataset, &lli->lli_fid,
+			  i_size_read(file_inode(pcc_file)));
+	atomic64_inc(&dataset->pccd_ro_hits);
+	CDEBUG(D_CACHE, "%s: opened RO-PCC copy of "DFID"\n",
+	       dataset->pccd_pathname, PFID(&lli->lli_fid));
+
+	WARN_ON(pccf->pccf_file);
+	pccf->pccf_file = pcc_file;
+	pccf->pccf_type = LU_PCC_READONLY;
+	/* the reference is dropped in pcc_file_release() */
+	pccf->pccf_dataset = dataset;
+	revert_creds(old_cred);
+	RETURN_EXIT;
+
+out_fetch:
+	CDEBUG(D_CACHE, "%s: no valid RO-PCC copy of "DFID": rc = %d\n",
+	       dataset->pccd_pathname, PFID(&lli->lli_fid), rc);
+	atomic64_inc(&dataset->pccd_ro_misses);
+	pcc_ro_fetch(inode, file, dataset);
+out_put:
+	revert_creds(old_cred);
+	pcc_dataset_put(dataset);
+	EXIT;
+}
+
 int pcc_file_open(struct inode *inode, struct file *file)
 {
 	struct pcc_inode *pcci;
@@ -1494,6 +1851,7 @@ int pcc_file_open(struct inode *inode, struct file *file)
 	struct file *pcc_file;
 	struct path *path;
 	bool cached = false;
+	bool readonly = false;
 	int rc = 0;
 
 	ENTRY;
@@ -1514,6 +1872,9 @@ int pcc_file_open(struct inode *inode, struct file *file)
 		if (pcc_may_auto_attach(inode, PIT_OPEN))
 			rc = pcc_try_auto_attach(inode, &cached, PIT_OPEN);
 
+		/* not in RW-PCC, try the RO-PCC copy out of the lock */
+		if (rc == 0 && !cached)
+			readonly = true;
 		if (rc < 0 || !cached)
 			GOTO(out_unlock, rc);
 
@@ -1539,6 +1900,8 @@ int pcc_file_open(struct inode *inode, struct file *file)
 
 out_unlock:
 	pcc_inode_unlock(inode);
+	if (readonly)
+		pcc_readonly_open(inode, file);
 	RETURN(rc);
 }
 
@@ -1559,6 +1922,15 @@ void pcc_file_release(struct inode *inode, struct file *file)
 	if (pccf->pccf_file == NULL)
 		goto out;
 
+	/* RO-PCC copy is opened per file, without a PCC inode */
+	if (pccf->pccf_type == LU_PCC_READONLY) {
+		fput(pccf->pccf_file);
+		pccf->pccf_file = NULL;
+		pcc_dataset_put(pccf->pccf_dataset);
+		pccf->pccf_dataset = NULL;
+		goto out;
+	}
+
 	pcci = ll_i2pcci(inode);
 	LASSERT(pcci);
 	path = &pcci->pcci_path;
@@ -1656,6 +2028,18 @@ ssize_t pcc_file_read_iter(struct kiocb *iocb,
 		RETURN(0);
 	}
 
+	if (pccf->pccf_type == LU_PCC_READONLY) {
+		iocb->ki_filp = pccf->pccf_file;
+		result = __pcc_file_read_iter(iocb, iter);
+		iocb->ki_filp = file;
+		/* the data is on OSTs as well, read it from there on error */
+		*cached = result >= 0;
+		if (result > 0)
+			atomic64_add(result,
+				     &pccf->pccf_dataset->pccd_ro_hit_bytes);
+		RETURN(*cached ? result : 0);
+	}
+
 	pcc_io_init(inode, PIT_READ, cached);
 	if (!*cached)
 		RETURN(0);
@@ -2443,6 +2827,107 @@ out_free:
 	RETURN(rc);
 }
 
+/* Copy a file into a RO-PCC dataset, queued by pcc_ro_fetch() */
+static void pcc_ro_fetch_work(struct work_struct *work)
+{
+	struct pcc_ro_fetch_work *prw = container_of(work,
+						     struct pcc_ro_fetch_work,
+						     prw_work);
+	struct pcc_dataset *dataset = prw->prw_dataset;
+	struct inode *inode = d_inode(prw->prw_path.dentry);
+	struct ll_inode_info *lli = ll_i2info(inode);
+	const struct cred *old_cred;
+	struct dentry *pcc_dentry;
+	struct file *pcc_filp;
+	struct file *filp;
+	struct path path;
+	ssize_t ret = 0;
+	__u64 dv2;
+	__u64 dv;
+	int rc;
+
+	ENTRY;
+
+	old_cred = override_creds(ll_i2pccs(inode)->pccs_cred);
+	rc = ll_data_version(inode, &dv, LL_DV_RD_FLUSH);
+	if (rc)
+		GOTO(out, rc);
+
+	rc = __pcc_inode_create(dataset, &lli->lli_fid, &pcc_dentry);
+	if (rc)
+		GOTO(out, rc);
+
+	/* a stale copy must not look valid while it is rewritten */
+	(void) ll_vfs_removexattr(pcc_dentry, pcc_dentry->d_inode,
+				  pcc_xattr_dv);
+
+	path.mnt = dataset->pccd_path.mnt;
+	path.dentry = pcc_dentry;
+	pcc_filp = dentry_open(&path, O_WRONLY | O_LARGEFILE, current_cred());
+	if (IS_ERR_OR_NULL(pcc_filp)) {
+		rc = pcc_filp == NULL ? -EINVAL : PTR_ERR(pcc_filp);
+		GOTO(out_dentry, rc);
+	}
+
+	/*
+	 * PCC_STATE_FL_ATTACHING keeps this open out of PCC, and out of the
+	 * RO-PCC hits and misses, see pcc_readonly_open()
+	 */
+	filp = dentry_open(&prw->prw_path, O_RDONLY | O_LARGEFILE,
+			   current_cred());
+	if (IS_ERR_OR_NULL(filp)) {
+		rc = filp == NULL ? -EINVAL : PTR_ERR(filp);
+		GOTO(out_fput, rc);
+	}
+
+	ret = pcc_copy_data(filp, pcc_filp);
+	fput(filp);
+	if (ret < 0)
+		GOTO(out_fput, rc = ret);
+
+	rc = pcc_inode_reset_iattr(pcc_dentry, ATTR_SIZE, KUIDT_INIT(0),
+				   KGIDT_INIT(0), ret);
+	if (rc)
+		GOTO(out_fput, rc);
+
+	/* the file was modified during the copy */
+	rc = ll_data_version(inode, &dv2, LL_DV_RD_FLUSH);
+	if (rc == 0 && dv2 != dv)
+		rc = -ESTALE;
+	if (rc)
+		GOTO(out_fput, rc);
+
+	rc = ll_vfs_setxattr(pcc_dentry, pcc_dentry->d_inode, pcc_xattr_dv,
+			     &dv, sizeof(dv), 0);
+	if (rc)
+		GOTO(out_fput, rc);
+
+	atomic64_inc(&dataset->pccd_ro_fetches);
+	atomic64_add(ret, &dataset->pccd_ro_fetch_bytes);
+	pcc_ro_lru_update(dataset, &lli->lli_fid, ret);
+out_fput:
+	fput(pcc_filp);
+out_dentry:
+	if (rc) {
+		pcc_ro_lru_del(dataset, &lli->lli_fid);
+		pcc_ro_unlink(dataset, pcc_dentry);
+	}
+	dput(pcc_dentry);
+out:
+	CDEBUG(D_CACHE, "%s: RO-PCC fetch of "DFID" (%zd bytes): rc = %d\n",
+	       dataset->pccd_pathname, PFID(&lli->lli_fid), ret, rc);
+
+	pcc_inode_lock(inode);
+	lli->lli_pcc_state &= ~PCC_STATE_FL_ATTACHING;
+	pcc_inode_unlock(inode);
+
+	revert_creds(old_cred);
+	path_put(&prw->prw_path);
+	pcc_dataset_put(dataset);
+	OBD_FREE_PTR(prw);
+	EXIT;
+}
+
 static int pcc_attach_allowed_check(struct inode *inode)
 {
 	struct ll_inode_info *lli = ll_i2info(inode);
@@ -2715,6 +3200,14 @@ int pcc_ioctl_state(struct file *file, struct inode *inode,
 
 	pcc_inode_lock(inode);
 	pcci = ll_i2pcci(inode);
+	if (pcci == NULL && pccf->pccf_type == LU_PCC_READONLY) {
+		state->pccs_type = LU_PCC_READONLY;
+		state->pccs_open_count = 0;
+		state->pccs_flags = 0;
+		path = dentry_path_raw(pccf->pccf_file->f_path.dentry, buf,
+				       buf_len);
+		GOTO(out_path, rc = 0);
+	}
 	if (pcci == NULL) {
 		state->pccs_type = LU_PCC_NONE;
 		GOTO(out_unlock, rc = 0);
@@ -2735,6 +3228,7 @@ int pcc_ioctl_state(struct file *file, struct inode *inode,
 	state->pccs_open_count = count;
 	state->pccs_flags = ll_i2info(inode)->lli_pcc_state;
 	path = dentry_path_raw(pcci->pcci_path.dentry, buf, buf_len);
+out_path:
 	if (IS_ERR(path))
 		GOTO(out_unlock, rc = PTR_ERR(path));
 
@@ -36,6 +36,7 @@
 #include <linux/fs.h>
 #include <linux/seq_file.h>
 #include <linux/mm.h>
+#include <linux/rhashtable.h>
 #include <uapi/linux/lustre/lustre_user.h>
 
 extern struct kmem_cache *pcc_inode_slab;
@@ -111,6 +112,15 @@ enum pcc_dataset_flags {
 	PCC_DATASET_PCC_ALL	= PCC_DATASET_RWPCC | PCC_DATASET_ROPCC,
 };
 
+/* RO-PCC copy tracked in the LRU of its dataset */
+struct pcc_ro_entry {
+	struct lu_fid		pre_fid;
+	struct rhash_head	pre_hash;	/* Linked to pccd_ro_hash */
+	struct list_head	pre_lru;	/* Linked to pccd_ro_lru */
+	__u64			pre_size;	/* Size of the PCC copy */
+	struct rcu_head		pre_rcu;
+};
+
 struct pcc_dataset {
 	__u32			pccd_rwid;	 /* Archive ID */
 	__u32			pccd_roid;	 /* Readonly ID */
@@ -120,6 +130,21 @@ struct pcc_dataset {
 	struct path		pccd_path;	 /* Root path */
 	struct list_head	pccd_linkage;  /* Linked to pccs_datasets */
 	atomic_t		pccd_refcount; /* Reference count */
+	/* RO-PCC copies, least recently used first */
+	spinlock_t		pccd_ro_lock;
+	struct list_head	pccd_ro_lru;
+	struct rhashtable	pccd_ro_hash;
+	/* Bytes used by the copies in pccd_ro_lru, protected by pccd_ro_lock */
+	__u64			pccd_ro_bytes;
+	/* Max bytes of RO-PCC copies, 0 for unlimited */
+	__u64			pccd_ro_capacity;
+	/* RO-PCC statistics */
+	atomic64_t		pccd_ro_hits;
+	atomic64_t		pccd_ro_misses;
+	atomic64_t		pccd_ro_hit_bytes;
+	atomic64_t		pccd_ro_fetches;
+	atomic64_t		pccd_ro_fetch_bytes;
+	atomic64_t		pccd_ro_evictions;
 };
 
 struct pcc_super {
@@ -135,6 +160,8 @@ struct pcc_super {
 	 * parameters for PCC.
 	 */
 	__u64			 pccs_generation;
+	/* Copy files into RO-PCC datasets in the background */
+	struct workqueue_struct	*pccs_ro_wq;
 };
 
 struct pcc_inode {
@@ -166,6 +193,8 @@ struct pcc_file {
 	struct file		*pccf_file;
 	/* Whether readonly or readwrite PCC */
 	enum lu_pcc_type	 pccf_type;
+	/* Dataset of the RO-PCC copy, for the statistics */
+	struct pcc_dataset	*pccf_dataset;
 };
 
 enum pcc_io_type {
@@ -207,6 +236,7 @@ struct pcc_cmd {
 			struct list_head	 pccc_conds;
 			char			*pccc_conds_str;
 			enum pcc_dataset_flags	 pccc_flags;
+			__u64			 pccc_ro_capacity;
 		} pccc_add;
 		struct pcc_cmd_del {
 			__u32			 pccc_pad;
@@ -261,6 +291,7 @@ int pcc_inode_create_fini(struct inode *inode, struct pcc_create_attach *pca);
 void pcc_create_attach_cleanup(struct super_block *sb,
 			       struct pcc_create_attach *pca);
 struct pcc_dataset *pcc_dataset_match_get(struct pcc_super *super,
+					  enum lu_pcc_type type,
 					  struct pcc_matcher *matcher);
 void pcc_dataset_put(struct pcc_dataset *dataset);
 void pcc_inode_free(struct inode *inode);
@@ -149,6 +149,9 @@ void ll_ra_stats_inc(struct inode *inode, enum ra_stat which)
 {
 	struct ll_sb_info *sbi = ll_i2sbi(inode);
 	ll_ra_stats_inc_sbi(sbi, which);
+
+	if (which == RA_STAT_DISCARDED && S_ISREG(inode->i_mode))
+		atomic_inc(&ll_i2info(inode)->lli_ra_discarded);
 }
 
 #define RAS_CDEBUG(ras) \
@@ -533,13 +536,53 @@ static void ll_readahead_work_free(struct ll_readahead_work *work)
 	OBD_FREE_PTR(work);
 }
 
+/*
+ * Pick the CPU partition to run async readahead on: the one of the calling
+ * thread, so that readahead pages are allocated on its NUMA node, unless
+ * that has its share of max_read_ahead_async_active works in flight; then
+ * the least busy partition which has room.
+ *
+ * \retval	partition to queue the work to
+ * \retval	-EBUSY if all partitions are busy
+ */
+static int ll_readahead_cpt(struct ll_ra_info *ra)
+{
+	int share = max_t(int, DIV_ROUND_UP(ra->ra_async_max_active,
+					    ra->ra_cpt_count), 1);
+	int cpt = cfs_cpt_current(cfs_cpt_tab, 1);
+	int best = -EBUSY;
+	int inflight;
+	int i;
+
+	if (cpt < 0 || cpt >= ra->ra_cpt_count)
+		cpt = 0;
+	if (atomic_read(&ra->ra_cpts[cpt].rac_inflight) < share)
+		return cpt;
+
+	for (i = 0; i < ra->ra_cpt_count; i++) {
+		inflight = atomic_read(&ra->ra_cpts[i].rac_inflight);
+		if (inflight < share) {
+			share = inflight;
+			best = i;
+		}
+	}
+	if (best >= 0)
+		atomic_inc(&ra->ra_cpts[cpt].rac_redirected);
+
+	return best;
+}
+
 static void ll_readahead_handle_work(struct work_struct *wq);
 static void ll_readahead_work_add(struct inode *inode,
-				  struct ll_readahead_work *work)
+				  struct ll_readahead_work *work, int cpt)
 {
+	struct ll_ra_cpt *rac = &ll_i2sbi(inode)->ll_ra_info.ra_cpts[cpt];
+
+	work->lrw_cpt = cpt;
+	work->lrw_queued = ktime_get();
+	atomic_inc(&rac->rac_queued);
 	INIT_WORK(&work->lrw_readahead_work, ll_readahead_handle_work);
-	queue_work(ll_i2sbi(inode)->ll_ra_info.ll_readahead_wq,
-		   &work->lrw_readahead_work);
+	queue_work(rac->rac_wq, &work->lrw_readahead_work);
 }
 
 static int ll_readahead_file_kms(const struct lu_env *env,
@@ -578,6 +621,8 @@ static void ll_readahead_handle_work(struct work_struct *wq)
 	pgoff_t ra_end_idx = 0;
 	unsigned long pages, pages_min = 0;
 	struct file *file;
+	struct ll_ra_cpt *rac;
+	ktime_t start;
 	__u64 kms;
 	int rc;
 	pgoff_t eof_index;
@@ -586,10 +631,14 @@ static void ll_readahead_handle_work(struct work_struct *wq)
 	work = container_of(wq, struct ll_readahead_work,
 			    lrw_readahead_work);
 	fd = work->lrw_file->private_data;
-	ras = &fd->fd_ras;
+	ras = work->lrw_ras;
 	file = work->lrw_file;
 	inode = file_inode(file);
 	sbi = ll_i2sbi(inode);
+	rac = &sbi->ll_ra_info.ra_cpts[work->lrw_cpt];
+	start = ktime_get();
+	lprocfs_oh_tally_log2(&rac->rac_wait_hist,
+			      ktime_us_delta(start, work->lrw_queued));
 
 	CDEBUG(D_READA|D_IOTRACE,
 	       "%s: async ra from %lu to %lu triggered by user pid %d\n",
@@ -696,7 +745,9 @@ out_put_env:
 out_free_work:
 	if (ra_end_idx > 0)
 		ll_ra_stats_inc_sbi(ll_i2sbi(inode), RA_STAT_ASYNC);
-	atomic_dec(&sbi->ll_ra_info.ra_async_inflight);
+	lprocfs_oh_tally_log2(&rac->rac_run_hist,
+			      ktime_us_delta(ktime_get(), start));
+	atomic_dec(&rac->rac_inflight);
 	ll_readahead_work_free(work);
 }
 
@@ -859,6 +910,8 @@ static int ll_readahead(const struct lu_env *env, struct cl_io *io,
 		 * where we left off. */
 		spin_lock(&ras->ras_lock);
 		ras->ras_next_readahead_idx = ra_end_idx + 1;
+		if (ret > 0)
+			ras->ras_fb_ra_pages += ret;
 		spin_unlock(&ras->ras_lock);
 		RAS_CDEBUG(ras);
 	}
@@ -930,17 +983,33 @@ static void ras_stride_reset(struct ll_readahead_state *ras)
         RAS_CDEBUG(ras);
 }
 
-void ll_readahead_init(struct inode *inode, struct ll_readahead_state *ras)
+/* called with the ras_lock held or from places where it doesn't matter */
+static void ras_stream_init(struct ll_readahead_state *ras)
 {
-	spin_lock_init(&ras->ras_lock);
 	ras->ras_rpc_pages = PTLRPC_MAX_BRW_PAGES;
 	ras_reset(ras, 0);
+	ras_stride_reset(ras);
 	ras->ras_last_read_end_bytes = 0;
 	ras->ras_requests = 0;
 	ras->ras_range_min_start_idx = 0;
 	ras->ras_range_max_end_idx = 0;
 	ras->ras_range_requests = 0;
 	ras->ras_last_range_pages = 0;
+	ras->ras_stream_requests = 0;
+	ras->ras_fb_start = 0;
+}
+
+void ll_readahead_init(struct inode *inode, struct ll_file_data *fd)
+{
+	int i;
+
+	spin_lock_init(&fd->fd_ras_lock);
+	for (i = 0; i < LL_RA_STREAMS_MAX; i++) {
+		spin_lock_init(&fd->fd_ras[i].ras_lock);
+		ras_stream_init(&fd->fd_ras[i]);
+	}
+	fd->fd_ras_count = 1;
+	fd->fd_ras_last = &fd->fd_ras[0];
 }
 
 /*
@@ -1057,21 +1126,91 @@ out:
 	RAS_CDEBUG(ras);
 }
 
+/* minimum feedback sample before the window is sized from it */
+#define RAS_FEEDBACK_MIN_MS	10
+
+/*
+ * Pages to grow the readahead window by, from the feedback of the current
+ * sampling period: if more than a quarter of the pages read ahead got
+ * discarded unused or were left behind by the reader seeking elsewhere, the
+ * window is halved and not grown; otherwise it grows
+ * faster until it covers ra_feedback_ms of reading at the rate the reader
+ * consumes pages, and then stays there. Falls back to growing by one RPC
+ * until there is enough of a sample to tell.
+ *
+ * called with the ras_lock held
+ */
+static unsigned long ras_feedback_pages(struct inode *inode,
+					struct ll_readahead_state *ras,
+					struct ll_ra_info *ra)
+{
+	int discarded = atomic_read(&ll_i2info(inode)->lli_ra_discarded);
+	unsigned long inc = ras->ras_rpc_pages;
+	unsigned long wasted;
+	unsigned long target;
+	ktime_t now = ktime_get();
+	s64 elapsed_ms;
+
+	if (!ras->ras_fb_start) {
+		ras->ras_fb_start = now;
+		ras->ras_fb_ra_pages = 0;
+		ras->ras_fb_read_pages = 0;
+		ras->ras_fb_skipped = 0;
+		ras->ras_fb_discarded = discarded;
+		return inc;
+	}
+
+	elapsed_ms = ktime_ms_delta(now, ras->ras_fb_start);
+	if (elapsed_ms < RAS_FEEDBACK_MIN_MS || ras->ras_fb_ra_pages == 0)
+		return inc;
+
+	wasted = max(discarded - ras->ras_fb_discarded, 0) +
+		 ras->ras_fb_skipped;
+	if (wasted * 4 > ras->ras_fb_ra_pages) {
+		ras->ras_window_pages = max(ras->ras_window_pages / 2,
+					    ras->ras_rpc_pages);
+		ll_ra_stats_inc(inode, RA_STAT_FEEDBACK_THROTTLE);
+		inc = 0;
+	} else {
+		target = div64_u64((u64)ras->ras_fb_read_pages *
+				   ra->ra_feedback_ms, elapsed_ms);
+		if (target > ras->ras_window_pages) {
+			inc = max(ras->ras_window_pages, ras->ras_rpc_pages);
+			inc = min(inc, target - ras->ras_window_pages);
+			ll_ra_stats_inc(inode, RA_STAT_FEEDBACK_RAMP_UP);
+		} else {
+			inc = 0;
+		}
+	}
+
+	/* start a new sample once this one covers the feedback period */
+	if (elapsed_ms >= ra->ra_feedback_ms)
+		ras->ras_fb_start = 0;
+
+	return inc;
+}
+
 static void ras_increase_window(struct inode *inode,
 				struct ll_readahead_state *ras,
 				struct ll_ra_info *ra)
 {
+	unsigned long inc = ras->ras_rpc_pages;
+
+	if (ra->ra_feedback_ms)
+		inc = ras_feedback_pages(inode, ras, ra);
+
 	/* The stretch of ra-window should be aligned with max rpc_size
 	 * but current clio architecture does not support retrieve such
 	 * information from lower layer. FIXME later
 	 */
 	if (stride_io_mode(ras)) {
-		ras_stride_increase_window(ras, ra,
-				      (loff_t)ras->ras_rpc_pages << PAGE_SHIFT);
+		if (inc > 0)
+			ras_stride_increase_window(ras, ra,
+						   (loff_t)inc << PAGE_SHIFT);
 	} else {
 		pgoff_t window_pages;
 
-		window_pages = min(ras->ras_window_pages + ras->ras_rpc_pages,
+		window_pages = min(ras->ras_window_pages + inc,
 				   ra->ra_max_pages_per_file);
 		if (window_pages < ras->ras_rpc_pages)
 			ras->ras_window_pages = window_pages;
@@ -1162,6 +1301,7 @@ static void ras_detect_read_pattern(struct ll_readahead_state *ras,
 {
 	bool stride_detect = false;
 	pgoff_t index = pos >> PAGE_SHIFT;
+	pgoff_t next_idx;
 
 	/*
 	 * Reset the read-ahead window in two cases. First when the app seeks
@@ -1178,6 +1318,12 @@ static void ras_detect_read_pattern(struct ll_readahead_state *ras,
 			else
 				ras_stride_reset(ras);
 			ras->ras_consecutive_bytes = 0;
+			/* pages read ahead past the last read go unused */
+			next_idx = (ras->ras_last_read_end_bytes >>
+				    PAGE_SHIFT) + 1;
+			if (ras->ras_next_readahead_idx > next_idx)
+				ras->ras_fb_skipped +=
+					ras->ras_next_readahead_idx - next_idx;
 			ras_reset(ras, index);
 		} else {
 			ras->ras_consecutive_bytes = 0;
@@ -1218,10 +1364,136 @@ static void ras_detect_read_pattern(struct ll_readahead_state *ras,
 	ras->ras_last_read_end_bytes = pos + count - 1;
 }
 
+/*
+ * Distance in pages from @index to the pages @ras read in its current run,
+ * or is reading ahead.
+ */
+static pgoff_t ras_stream_distance(struct ll_readahead_state *ras,
+				   pgoff_t index)
+{
+	loff_t end_bytes = ras->ras_last_read_end_bytes;
+	pgoff_t start = 0;
+	pgoff_t end;
+
+	if (end_bytes + 1 > ras->ras_consecutive_bytes)
+		start = (end_bytes + 1 - ras->ras_consecutive_bytes) >>
+			PAGE_SHIFT;
+	end = max_t(pgoff_t, end_bytes >> PAGE_SHIFT,
+		    ras->ras_window_start_idx + ras->ras_window_pages);
+
+	if (index < start)
+		return start - index;
+	if (index > end)
+		return index - end;
+	return 0;
+}
+
+static unsigned int ll_ras_streams(struct ll_file_data *fd,
+				   struct ll_sb_info *sbi)
+{
+	return min3(sbi->ll_ra_info.ra_streams, fd->fd_ras_count,
+		    (unsigned int)LL_RA_STREAMS_MAX);
+}
+
+/*
+ * Find the readahead stream of @fd which page @index belongs to, i.e. the
+ * nearest one.
+ */
+static struct ll_readahead_state *ll_ras_find(struct ll_file_data *fd,
+					      struct ll_sb_info *sbi,
+					      pgoff_t index)
+{
+	unsigned int streams = ll_ras_streams(fd, sbi);
+	struct ll_readahead_state *ras;
+	pgoff_t best = ULONG_MAX;
+	pgoff_t distance;
+	int i;
+
+	if (streams <= 1)
+		return &fd->fd_ras[0];
+
+	spin_lock(&fd->fd_ras_lock);
+	ras = fd->fd_ras_last;
+	for (i = 0; i < streams && best > 0; i++) {
+		distance = ras_stream_distance(&fd->fd_ras[i], index);
+		if (distance < best) {
+			best = distance;
+			ras = &fd->fd_ras[i];
+		}
+	}
+	spin_unlock(&fd->fd_ras_lock);
+
+	return ras;
+}
+
+/*
+ * Pick the readahead stream of @fd for a read of @count bytes at @pos, so
+ * that several threads reading different parts of a file through the same
+ * file descriptor don't reset the readahead window of each other:
+ *
+ * - the stream whose sequential read or stride the read continues, or
+ *   whose readahead window it reads from;
+ * - otherwise the stream which got the previous read if it had no other
+ *   read so far, so that it can still tell a stride;
+ * - otherwise a new stream, replacing the least recently used one if all
+ *   read_ahead_streams are taken.
+ */
+static struct ll_readahead_state *ll_ras_stream(struct file *file,
+						loff_t pos, size_t count)
+{
+	struct ll_file_data *fd = file->private_data;
+	struct ll_sb_info *sbi = ll_i2sbi(file_inode(file));
+	unsigned int max_streams = min_t(unsigned int,
+					 sbi->ll_ra_info.ra_streams,
+					 LL_RA_STREAMS_MAX);
+	unsigned int streams = ll_ras_streams(fd, sbi);
+	struct ll_readahead_state *lru = NULL;
+	struct ll_readahead_state *ras;
+	pgoff_t index = pos >> PAGE_SHIFT;
+	int i;
+
+	if (max_streams <= 1)
+		return &fd->fd_ras[0];
+
+	spin_lock(&fd->fd_ras_lock);
+	for (i = 0; i < streams; i++) {
+		ras = &fd->fd_ras[i];
+		if (is_loose_seq_read(ras, pos) ||
+		    read_in_stride_window(ras, pos, count) ||
+		    ras_stream_distance(ras, index) == 0)
+			GOTO(out_unlock, ras);
+		if (!lru || time_before(ras->ras_stream_access,
+					lru->ras_stream_access))
+			lru = ras;
+	}
+
+	ras = fd->fd_ras_last;
+	if (ras - fd->fd_ras < streams && ras->ras_stream_requests <= 1)
+		GOTO(out_unlock, ras);
+
+	if (fd->fd_ras_count < max_streams) {
+		ras = &fd->fd_ras[fd->fd_ras_count++];
+	} else {
+		ras = lru;
+		spin_lock(&ras->ras_lock);
+		ras_stream_init(ras);
+		spin_unlock(&ras->ras_lock);
+	}
+	ras->ras_stream_requests = 0;
+	ll_ra_stats_inc_sbi(sbi, RA_STAT_NEW_STREAM);
+
+out_unlock:
+	ras->ras_stream_requests++;
+	ras->ras_stream_access = jiffies;
+	fd->fd_ras_last = ras;
+	spin_unlock(&fd->fd_ras_lock);
+
+	return ras;
+}
+
 void ll_ras_enter(struct file *f, loff_t pos, size_t count)
 {
-	struct ll_file_data *fd = f->private_data;
-	struct ll_readahead_state *ras = &fd->fd_ras;
+	struct ll_readahead_state *ras = ll_ras_stream(f, pos, count);
 	struct inode *inode = file_inode(f);
 	unsigned long index = pos >> PAGE_SHIFT;
 	struct ll_sb_info *sbi = ll_i2sbi(inode);
@@ -1308,6 +1580,7 @@ static void ras_update(struct ll_sb_info *sbi, struct inode *inode,
 		CDEBUG(D_READA|D_IOTRACE, DFID " pages at %lu miss.\n",
 		       PFID(ll_inode2fid(inode)), index);
 	ll_ra_stats_inc_sbi(sbi, hit ? RA_STAT_HIT : RA_STAT_MISS);
+	ras->ras_fb_read_pages++;
 
 	/*
 	 * The readahead window has been expanded to cover whole
@@ -1636,9 +1909,10 @@ int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 	bool unlockpage = true;
 	ENTRY;
 
+	vpg = cl2vvp_page(cl_object_page_slice(page->cp_obj, page));
 	if (file) {
 		fd = file->private_data;
-		ras = &fd->fd_ras;
+		ras = ll_ras_find(fd, sbi, vvp_index(vpg));
 	}
 
 	/* PagePrivate2 is set in ll_io_zero_page() to tell us the vmpage
@@ -1647,7 +1921,6 @@ int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
 	if (page->cp_vmpage && PagePrivate2(page->cp_vmpage))
 		unlockpage = false;
 
-	vpg = cl2vvp_page(cl_object_page_slice(page->cp_obj, page));
 	uptodate = vpg->vpg_defer_uptodate;
 
 	if (ll_readahead_enabled(sbi) && !vpg->vpg_ra_updated && ras) {
@@ -1747,15 +2020,16 @@ int ll_io_read_page(const struct lu_env *env, struct cl_io *io,
  * 2 async readahead triggered and fast read could be used too.
  * < 0 on error.
  */
-static int kickoff_async_readahead(struct file *file, unsigned long pages)
+static int kickoff_async_readahead(struct file *file,
+				   struct ll_readahead_state *ras,
+				   unsigned long pages)
 {
 	struct ll_readahead_work *lrw;
 	struct inode *inode = file_inode(file);
 	struct ll_sb_info *sbi = ll_i2sbi(inode);
-	struct ll_file_data *fd = file->private_data;
-	struct ll_readahead_state *ras = &fd->fd_ras;
 	struct ll_ra_info *ra = &sbi->ll_ra_info;
 	unsigned long throttle;
+	int cpt;
 	pgoff_t start_idx = ras_align(ras, ras->ras_next_readahead_idx);
 	pgoff_t end_idx = start_idx + pages - 1;
 
@@ -1776,8 +2050,7 @@ static int kickoff_async_readahead(struct file *file, unsigned long pages)
 	 * we do async readahead, allowing the user thread to do fast i/o.
 	 */
 	if (stride_io_mode(ras) || !throttle ||
-	    ras->ras_window_pages < throttle ||
-	    atomic_read(&ra->ra_async_inflight) > ra->ra_async_max_active)
+	    ras->ras_window_pages < throttle)
 		return 0;
 
 	if ((atomic_read(&ra->ra_cur_pages) + pages) > ra->ra_max_pages)
@@ -1786,11 +2059,16 @@ static int kickoff_async_readahead(struct file *file, unsigned long pages)
 	if (ras->ras_async_last_readpage_idx == start_idx)
 		return 1;
 
+	cpt = ll_readahead_cpt(ra);
+	if (cpt < 0)
+		return 0;
+
 	/* ll_readahead_work_free() free it */
 	OBD_ALLOC_PTR(lrw);
 	if (lrw) {
-		atomic_inc(&sbi->ll_ra_info.ra_async_inflight);
+		atomic_inc(&ra->ra_cpts[cpt].rac_inflight);
 		lrw->lrw_file = get_file(file);
+		lrw->lrw_ras = ras;
 		lrw->lrw_start_idx = start_idx;
 		lrw->lrw_end_idx = end_idx;
 		lrw->lrw_user_pid = current->pid;
@@ -1800,7 +2078,7 @@ static int kickoff_async_readahead(struct file *file, unsigned long pages)
 		spin_unlock(&ras->ras_lock);
 		memcpy(lrw->lrw_jobid, ll_i2info(inode)->lli_jobid,
 		       sizeof(lrw->lrw_jobid));
-		ll_readahead_work_add(inode, lrw);
+		ll_readahead_work_add(inode, lrw, cpt);
 	} else {
 		return -ENOMEM;
 	}
@@ -1831,7 +2109,7 @@ static bool ll_use_fast_io(struct file *file,
 
 	if (ras->ras_window_start_idx + ras->ras_window_pages <
 	    ras->ras_next_readahead_idx + skip_pages ||
-	    kickoff_async_readahead(file, fast_read_pages) > 0)
+	    kickoff_async_readahead(file, ras, fast_read_pages) > 0)
 		return true;
 
 	return false;
@@ -1859,7 +2137,8 @@ int ll_readpage(struct file *file, struct page *vmpage)
 	if (io == NULL) { /* fast read */
 		struct inode *inode = file_inode(file);
 		struct ll_file_data *fd = file->private_data;
-		struct ll_readahead_state *ras = &fd->fd_ras;
+		struct ll_readahead_state *ras = ll_ras_find(fd, sbi,
+							     vmpage->index);
 		struct lu_env  *local_env = NULL;
 		struct vvp_page *vpg;
 
@@ -1960,8 +2239,8 @@ int ll_readpage(struct file *file, struct page *vmpage)
 	 * with lockless i/o, and buffered requires LDLM locking, so in
 	 * this case we must restart without lockless.
 	 */
-	if (file->f_flags & O_DIRECT &&
-	    lcc && lcc->lcc_type == LCC_RW &&
+	if (lcc && lcc->lcc_type == LCC_RW &&
+	    ll_io_is_direct(file, io) &&
 	    !io->ci_dio_lock) {
 		unlock_page(vmpage);
 		io->ci_dio_lock = 1;
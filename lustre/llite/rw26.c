@@ -372,7 +372,11 @@ ll_direct_rw_pages(const struct lu_env *env, struct cl_io *io, size_t size,
 
 	cl_2queue_init(queue);
 	for (i = 0; i < pv->ldp_count; i++) {
-		LASSERT(!(offset & (PAGE_SIZE - 1)));
+		/* only the first page of unaligned DIO starts mid-page */
+		size_t from = offset & (PAGE_SIZE - 1);
+		size_t to = min_t(size_t, from + size, page_size);
+
+		LASSERT(from == 0 || (i == 0 && sdio->csd_unaligned));
 		page = cl_page_find(env, obj, cl_index(obj, offset),
 				    pv->ldp_pages[i], CPT_TRANSIENT);
 		if (IS_ERR(page)) {
@@ -405,12 +409,12 @@ ll_direct_rw_pages(const struct lu_env *env, struct cl_io *io, size_t size,
 		 * Set page clip to tell transfer formation engine
 		 * that page has to be sent even if it is beyond KMS.
 		 */
-		if (size < page_size)
-			cl_page_clip(env, page, 0, size);
+		if (from != 0 || to < page_size)
+			cl_page_clip(env, page, from, to);
 		++io_pages;
 
-		offset += page_size;
-		size -= page_size;
+		offset += to - from;
+		size -= to - from;
 	}
 	if (rc == 0 && io_pages > 0) {
 		int iot = rw == READ ? CRT_READ : CRT_WRITE;
@@ -446,6 +450,72 @@ ll_direct_rw_pages(const struct lu_env *env, struct cl_io *io, size_t size,
 	RETURN(rc);
 }
 
+/*
+ * Unaligned DIO is staged through bounce pages taken from the sptlrpc page
+ * pool.  The pages cover the file range [file_offset, file_offset + count)
+ * with the same in-page offset as the file, so the first and last pages may
+ * be partial and are clipped by ll_direct_rw_pages().
+ */
+static ssize_t ll_get_bounce_pages(struct ll_dio_pages *pv, loff_t file_offset,
+				   size_t count)
+{
+	size_t npages = DIV_ROUND_UP((file_offset & ~PAGE_MASK) + count,
+				     PAGE_SIZE);
+	int rc;
+
+	OBD_ALLOC_PTR_ARRAY_LARGE(pv->ldp_pages, npages);
+	if (pv->ldp_pages == NULL)
+		return -ENOMEM;
+
+	rc = sptlrpc_enc_pool_get_pages_array(pv->ldp_pages, npages);
+	if (rc) {
+		OBD_FREE_PTR_ARRAY_LARGE(pv->ldp_pages, npages);
+		pv->ldp_pages = NULL;
+		return rc;
+	}
+	pv->ldp_count = npages;
+
+	return count;
+}
+
+static void ll_put_bounce_pages(struct ll_dio_pages *pv)
+{
+	if (pv->ldp_pages == NULL)
+		return;
+
+	sptlrpc_enc_pool_put_pages_array(pv->ldp_pages, pv->ldp_count);
+	OBD_FREE_PTR_ARRAY_LARGE(pv->ldp_pages, pv->ldp_count);
+	pv->ldp_pages = NULL;
+	pv->ldp_count = 0;
+}
+
+/* copy between the user iterator and the bounce pages, advancing @iter */
+static ssize_t ll_bounce_copy(struct ll_dio_pages *pv, struct iov_iter *iter,
+			      size_t count, int rw)
+{
+	size_t offset = pv->ldp_file_offset & ~PAGE_MASK;
+	size_t done = 0;
+	int i;
+
+	for (i = 0; i < pv->ldp_count && done < count; i++) {
+		size_t bytes = min_t(size_t, PAGE_SIZE - offset, count - done);
+		size_t copied;
+
+		if (rw == WRITE)
+			copied = copy_page_from_iter(pv->ldp_pages[i], offset,
+						     bytes, iter);
+		else
+			copied = copy_page_to_iter(pv->ldp_pages[i], offset,
+						   bytes, iter);
+		done += copied;
+		if (copied < bytes)
+			return -EFAULT;
+		offset = 0;
+	}
+
+	return done;
+}
+
 #ifdef KMALLOC_MAX_SIZE
 #define MAX_MALLOC KMALLOC_MAX_SIZE
 #else
@@ -474,6 +544,7 @@ ll_direct_IO_impl(struct kiocb *iocb, struct iov_iter *iter, int rw)
 	ssize_t tot_bytes = 0, result = 0;
 	loff_t file_offset = iocb->ki_pos;
 	bool sync_submit = false;
+	bool unaligned = false;
 	struct vvp_io *vio;
 	ssize_t rc2;
 
@@ -481,19 +552,23 @@ ll_direct_IO_impl(struct kiocb *iocb, struct iov_iter *iter, int rw)
 	if (rw == READ && file_offset >= i_size_read(inode))
 		return 0;
 
-	/* FIXME: io smaller than PAGE_SIZE is broken on ia64 ??? */
-	if (file_offset & ~PAGE_MASK)
-		RETURN(-EINVAL);
-
 	CDEBUG(D_VFSTRACE, "VFS Op:inode="DFID"(%p), size=%zd (max %lu), "
 	       "offset=%lld=%llx, pages %zd (max %lu)\n",
 	       PFID(ll_inode2fid(inode)), inode, count, MAX_DIO_SIZE,
 	       file_offset, file_offset, count >> PAGE_SHIFT,
 	       MAX_DIO_SIZE >> PAGE_SHIFT);
 
-	/* Check that all user buffers are aligned as well */
-	if (ll_iov_iter_alignment(iter) & ~PAGE_MASK)
-		RETURN(-EINVAL);
+	/* Check that the file offset and all user buffers are aligned.
+	 * Unaligned I/O is copied through bounce pages if allowed, except
+	 * for encrypted files, which need whole pages for llcrypt.
+	 */
+	if ((file_offset & ~PAGE_MASK) ||
+	    (ll_iov_iter_alignment(iter) & ~PAGE_MASK)) {
+		if (!ll_sbi_has_unaligned_dio(ll_i2sbi(inode)) ||
+		    IS_ENCRYPTED(inode))
+			RETURN(-EINVAL);
+		unaligned = true;
+	}
 
 	lcc = ll_cl_find(inode);
 	if (lcc == NULL)
@@ -522,11 +597,20 @@ ll_direct_IO_impl(struct kiocb *iocb, struct iov_iter *iter, int rw)
 	if (io->ci_dio_lock || (is_sync_kiocb(iocb) && !io->ci_parallel_dio))
 		sync_submit = true;
 
+	/* Bounce pages are filled from (for writes) or copied back to (for
+	 * reads) the user buffer in this thread, so unaligned DIO always
+	 * waits for each sub-I/O before moving on.
+	 */
+	if (unaligned)
+		sync_submit = true;
+
 	while (iov_iter_count(iter)) {
 		struct ll_dio_pages *pvec;
 		struct page **pages;
 
 		count = min_t(size_t, iov_iter_count(iter), MAX_DIO_SIZE);
+		if (unaligned)
+			count = min_t(size_t, count, PTLRPC_MAX_BRW_SIZE);
 		if (rw == READ) {
 			if (file_offset >= i_size_read(inode))
 				break;
@@ -544,21 +628,31 @@ ll_direct_IO_impl(struct kiocb *iocb, struct iov_iter *iter, int rw)
 			GOTO(out, result = -ENOMEM);
 
 		pvec = &ldp_aio->csd_dio_pages;
+		pvec->ldp_file_offset = file_offset;
+		ldp_aio->csd_unaligned = unaligned;
 
-		result = ll_get_user_pages(rw, iter, &pages,
-					   &pvec->ldp_count, count);
+		if (unaligned) {
+			result = ll_get_bounce_pages(pvec, file_offset, count);
+			if (result > 0 && rw == WRITE)
+				result = ll_bounce_copy(pvec, iter, count, rw);
+		} else {
+			result = ll_get_user_pages(rw, iter, &pages,
+						   &pvec->ldp_count, count);
+			if (result > 0)
+				pvec->ldp_pages = pages;
+		}
 		if (unlikely(result <= 0)) {
 			cl_sync_io_note(env, &ldp_aio->csd_sync, result);
 			if (sync_submit) {
 				LASSERT(ldp_aio->csd_creator_free);
+				if (unaligned)
+					ll_put_bounce_pages(pvec);
 				cl_sub_dio_free(ldp_aio);
 			}
 			GOTO(out, result);
 		}
 
 		count = result;
-		pvec->ldp_file_offset = file_offset;
-		pvec->ldp_pages = pages;
 
 		result = ll_direct_rw_pages(env, io, count,
 					    rw, inode, ldp_aio);
@@ -572,13 +666,22 @@ ll_direct_IO_impl(struct kiocb *iocb, struct iov_iter *iter, int rw)
 					     0);
 			if (result == 0 && rc2)
 				result = rc2;
+			if (result == 0 && unaligned && rw == READ) {
+				rc2 = ll_bounce_copy(pvec, iter, count, rw);
+				if (rc2 < 0)
+					result = rc2;
+			}
 			LASSERT(ldp_aio->csd_creator_free);
+			if (unaligned)
+				ll_put_bounce_pages(pvec);
 			cl_sub_dio_free(ldp_aio);
 		}
 		if (unlikely(result < 0))
 			GOTO(out, result);
 
-		iov_iter_advance(iter, count);
+		/* bounce copies have advanced the iterator already */
+		if (!unaligned)
+			iov_iter_advance(iter, count);
 		tot_bytes += count;
 		file_offset += count;
 	}
@@ -740,7 +843,7 @@ static int ll_write_begin(struct file *file, struct address_space *mapping,
 	env = lcc->lcc_env;
 	io  = lcc->lcc_io;
 
-	if (file->f_flags & O_DIRECT) {
+	if (ll_io_is_direct(file, io)) {
 		/* direct IO failed because it couldn't clean up cached pages,
 		 * this causes a problem for mirror write because the cached
 		 * page may belong to another mirror, which will result in
@@ -36,6 +36,7 @@
 #include <linux/highmem.h>
 #include <linux/pagemap.h>
 #include <linux/delay.h>
+#include <linux/ctype.h>
 
 #define DEBUG_SUBSYSTEM S_LLITE
 
@@ -476,6 +477,7 @@ static struct ll_statahead_info *ll_sai_alloc(struct dentry *dentry)
 	atomic_set(&sai->sai_refcount, 1);
 	sai->sai_max = LL_SA_RPC_MIN;
 	sai->sai_index = 1;
+	sai->sai_access_time = ktime_get_seconds();
 	init_waitqueue_head(&sai->sai_waitq);
 
 	INIT_LIST_HEAD(&sai->sai_interim_entries);
@@ -502,6 +504,8 @@ static inline void ll_sai_free(struct ll_statahead_info *sai)
 {
 	LASSERT(sai->sai_dentry != NULL);
 	dput(sai->sai_dentry);
+	if (sai->sai_list)
+		OBD_FREE_LARGE(sai->sai_list, sai->sai_list_size);
 	OBD_FREE_PTR(sai);
 }
 
@@ -663,8 +667,11 @@ static void sa_instantiate(struct ll_statahead_info *sai,
 		GOTO(out, rc = -EFAULT);
 
 	child = entry->se_inode;
-	/* revalidate; unlinked and re-created with the same name */
-	if (unlikely(!lu_fid_eq(&minfo->mi_data.op_fid2, &body->mbo_fid1))) {
+	/* revalidate; unlinked and re-created with the same name, the FID is
+	 * not known in advance if statahead is not driven by readdir
+	 */
+	if (unlikely(!fid_is_zero(&minfo->mi_data.op_fid2) &&
+		     !lu_fid_eq(&minfo->mi_data.op_fid2, &body->mbo_fid1))) {
 		if (child) {
 			entry->se_inode = NULL;
 			iput(child);
@@ -673,6 +680,10 @@ static void sa_instantiate(struct ll_statahead_info *sai,
 		GOTO(out, rc = -EAGAIN);
 	}
 
+	/* remote object, lookup needs another RPC to get its attributes */
+	if (unlikely(body->mbo_valid & OBD_MD_MDS))
+		GOTO(out, rc = -EAGAIN);
+
 	it->it_lock_handle = entry->se_handle;
 	rc = md_revalidate_lock(ll_i2mdexp(dir), it, ll_inode2fid(dir), NULL);
 	if (rc != 1)
@@ -1032,14 +1043,77 @@ static void ll_start_agl(struct dentry *parent, struct ll_statahead_info *sai)
 	EXIT;
 }
 
-/* statahead thread main function */
-static int ll_statahead_thread(void *arg)
+/*
+ * sleep until woken up, statahead not driven by readdir wakes up periodically
+ * to check whether the scanner still uses it.
+ *
+ * \retval	false if statahead is idle and should stop
+ */
+static bool sa_sleep(struct ll_statahead_info *sai)
+{
+	if (sai->sai_pattern == LSA_PATTERN_LS) {
+		schedule();
+		return true;
+	}
+
+	schedule_timeout(cfs_time_seconds(1));
+	return ktime_get_seconds() <= sai->sai_access_time + LL_SA_IDLE_SEC;
+}
+
+/*
+ * wait until there is room in statahead window, handle async stat replies and
+ * AGL meanwhile.
+ *
+ * \retval	false if statahead should stop
+ */
+static bool sa_wait_window(struct ll_statahead_info *sai)
+{
+	struct ll_inode_info *lli = ll_i2info(sai->sai_dentry->d_inode);
+	bool active = true;
+
+	while (({set_current_state(TASK_IDLE);
+		 /* matches smp_store_release() in ll_deauthorize_statahead() */
+		 smp_load_acquire(&sai->sai_task); })) {
+		if (sa_has_callback(sai)) {
+			__set_current_state(TASK_RUNNING);
+			sa_handle_callback(sai);
+		}
+
+		spin_lock(&lli->lli_agl_lock);
+		while (sa_sent_full(sai) && !agl_list_empty(sai)) {
+			struct ll_inode_info *clli;
+
+			__set_current_state(TASK_RUNNING);
+			clli = agl_first_entry(sai);
+			list_del_init(&clli->lli_agl_list);
+			spin_unlock(&lli->lli_agl_lock);
+
+			ll_agl_trigger(&clli->lli_vfs_inode, sai);
+			cond_resched();
+			spin_lock(&lli->lli_agl_lock);
+		}
+		spin_unlock(&lli->lli_agl_lock);
+
+		if (!sa_sent_full(sai))
+			break;
+		if (!sa_sleep(sai)) {
+			active = false;
+			break;
+		}
+	}
+	__set_current_state(TASK_RUNNING);
+
+	/* matches smp_store_release() in ll_deauthorize_statahead() */
+	return active && smp_load_acquire(&sai->sai_task);
+}
+
+/* statahead for entries in readdir order */
+static int sa_statahead_dirent(struct dentry *parent,
+			       struct ll_statahead_info *sai)
 {
-	struct dentry *parent = (struct dentry *)arg;
 	struct inode *dir = parent->d_inode;
 	struct ll_inode_info *lli = ll_i2info(dir);
 	struct ll_sb_info *sbi = ll_i2sbi(dir);
-	struct ll_statahead_info *sai = lli->lli_sai;
 	int first = 0;
 	struct md_op_data *op_data;
 	struct page *page = NULL;
@@ -1048,12 +1122,9 @@ static int ll_statahead_thread(void *arg)
 
 	ENTRY;
 
-	CDEBUG(D_READA, "statahead thread starting: sai %p, parent %pd\n",
-	       sai, parent);
-
 	OBD_ALLOC_PTR(op_data);
 	if (!op_data)
-		GOTO(out, rc = -ENOMEM);
+		RETURN(-ENOMEM);
 
 	/* matches smp_store_release() in ll_deauthorize_statahead() */
 	while (pos != MDS_DIR_END_OFF && smp_load_acquire(&sai->sai_task)) {
@@ -1135,37 +1206,8 @@ static int ll_statahead_thread(void *arg)
 
 			fid_le_to_cpu(&fid, &ent->lde_fid);
 
-			while (({set_current_state(TASK_IDLE);
-				 /* matches smp_store_release() in
-				  * ll_deauthorize_statahead() */
-				 smp_load_acquire(&sai->sai_task); })) {
-				if (sa_has_callback(sai)) {
-					__set_current_state(TASK_RUNNING);
-					sa_handle_callback(sai);
-				}
-
-				spin_lock(&lli->lli_agl_lock);
-				while (sa_sent_full(sai) &&
-				       !agl_list_empty(sai)) {
-					struct ll_inode_info *clli;
-
-					__set_current_state(TASK_RUNNING);
-					clli = agl_first_entry(sai);
-					list_del_init(&clli->lli_agl_list);
-					spin_unlock(&lli->lli_agl_lock);
-
-					ll_agl_trigger(&clli->lli_vfs_inode,
-						       sai);
-					cond_resched();
-					spin_lock(&lli->lli_agl_lock);
-				}
-				spin_unlock(&lli->lli_agl_lock);
-
-				if (!sa_sent_full(sai))
-					break;
-				schedule();
-			}
-			__set_current_state(TASK_RUNNING);
+			if (!sa_wait_window(sai))
+				break;
 
 			if (IS_ENCRYPTED(dir)) {
 				struct llcrypt_str de_name =
@@ -1209,6 +1251,114 @@ static int ll_statahead_thread(void *arg)
 	}
 	ll_finish_md_op_data(op_data);
 
+	RETURN(rc);
+}
+
+/* statahead for names following the one which triggered it, by suffix */
+static int sa_statahead_fname(struct dentry *parent,
+			      struct ll_statahead_info *sai)
+{
+	struct lu_fid fid = { 0 };
+	int prefix = sai->sai_fname_prefix;
+	int len;
+
+	ENTRY;
+
+	while (sa_wait_window(sai)) {
+		if (sa_low_hit(sai)) {
+			atomic_inc(&ll_i2sbi(parent->d_inode)->ll_sa_wrong);
+			RETURN(-EFAULT);
+		}
+
+		len = snprintf(sai->sai_fname + prefix, NAME_MAX + 1 - prefix,
+			       "%0*llu", sai->sai_fname_width,
+			       sai->sai_fname_index);
+		if (prefix + len > NAME_MAX)
+			break;
+
+		sa_statahead(parent, sai->sai_fname, prefix + len, &fid);
+		if (++sai->sai_fname_index == 0)
+			break;
+	}
+
+	RETURN(0);
+}
+
+/* statahead for names or FIDs given by LL_IOC_STATAHEAD */
+static int sa_statahead_list(struct dentry *parent,
+			     struct ll_statahead_info *sai)
+{
+	struct ll_statahead_list *list = sai->sai_list;
+	char *buf = list->sal_buf;
+	char *end = buf + list->sal_size;
+	char fidname[FID_LEN + 1];
+	struct lu_fid zero_fid = { 0 };
+	__u32 i;
+
+	ENTRY;
+
+	for (i = 0; i < list->sal_count && sa_wait_window(sai); i++) {
+		const char *name;
+		int len;
+
+		if (sa_low_hit(sai)) {
+			atomic_inc(&ll_i2sbi(parent->d_inode)->ll_sa_wrong);
+			RETURN(-EFAULT);
+		}
+
+		if (list->sal_flags & LL_SA_LIST_FID) {
+			struct lu_fid *fid = (struct lu_fid *)buf + i;
+
+			if (!fid_is_sane(fid))
+				continue;
+			len = snprintf(fidname, sizeof(fidname), DFID,
+				       PFID(fid));
+			name = fidname;
+		} else {
+			if (buf >= end)
+				break;
+			name = buf;
+			len = strnlen(name, end - buf);
+			buf += len + 1;
+			if (len == 0 || len > NAME_MAX || strchr(name, '/') ||
+			    (name[0] == '.' &&
+			     (len == 1 || (len == 2 && name[1] == '.'))))
+				continue;
+		}
+
+		sa_statahead(parent, name, len, &zero_fid);
+	}
+
+	RETURN(0);
+}
+
+/* statahead thread main function */
+static int ll_statahead_thread(void *arg)
+{
+	struct dentry *parent = (struct dentry *)arg;
+	struct inode *dir = parent->d_inode;
+	struct ll_inode_info *lli = ll_i2info(dir);
+	struct ll_sb_info *sbi = ll_i2sbi(dir);
+	struct ll_statahead_info *sai = lli->lli_sai;
+	int rc;
+
+	ENTRY;
+
+	CDEBUG(D_READA, "statahead thread starting: sai %p, parent %pd\n",
+	       sai, parent);
+
+	switch (sai->sai_pattern) {
+	case LSA_PATTERN_FNAME:
+		rc = sa_statahead_fname(parent, sai);
+		break;
+	case LSA_PATTERN_LIST:
+		rc = sa_statahead_list(parent, sai);
+		break;
+	default:
+		rc = sa_statahead_dirent(parent, sai);
+		break;
+	}
+
 	if (rc < 0) {
 		spin_lock(&lli->lli_sa_lock);
 		sai->sai_task = NULL;
@@ -1218,7 +1368,7 @@ static int ll_statahead_thread(void *arg)
 
 	/*
 	 * statahead is finished, but statahead entries need to be cached, wait
-	 * for file release to stop me.
+	 * for file release to stop me, or for the scanner to go away.
 	 */
 	while (({set_current_state(TASK_IDLE);
 		/* matches smp_store_release() in ll_deauthorize_statahead() */
@@ -1226,14 +1376,13 @@ static int ll_statahead_thread(void *arg)
 		if (sa_has_callback(sai)) {
 			__set_current_state(TASK_RUNNING);
 			sa_handle_callback(sai);
-		} else {
-			schedule();
+		} else if (!sa_sleep(sai)) {
+			break;
 		}
 	}
 	__set_current_state(TASK_RUNNING);
 
 	EXIT;
-out:
 	ll_stop_agl(sai);
 
 	/*
@@ -1252,6 +1401,12 @@ out:
 
 	spin_lock(&lli->lli_sa_lock);
 	sai->sai_task = NULL;
+	/* statahead not driven by readdir owns the authorization itself */
+	if (lli->lli_opendir_key == sai) {
+		lli->lli_opendir_key = NULL;
+		lli->lli_opendir_pid = 0;
+		lli->lli_sa_enabled = 0;
+	}
 	spin_unlock(&lli->lli_sa_lock);
 	wake_up(&sai->sai_waitq);
 
@@ -1609,6 +1764,7 @@ out:
 	 */
 	if (lld_is_init(*dentryp))
 		ll_d2d(*dentryp)->lld_sa_generation = lli->lli_sa_generation;
+	sai->sai_access_time = ktime_get_seconds();
 	sa_put(sai, entry);
 	spin_lock(&lli->lli_sa_lock);
 	if (sai->sai_task)
@@ -1723,6 +1879,72 @@ out:
 	RETURN(rc);
 }
 
+/**
+ * start statahead thread which is not driven by readdir
+ *
+ * Such statahead is not tied to an open dir handle, it takes over the
+ * statahead authorization of @dir from the current process and gives it up
+ * once the scanner is idle, see ll_statahead_thread().
+ *
+ * \param[in] parent	directory to statahead
+ * \param[in] sai	prepared sai, freed by the caller upon error
+ * \param[in] agl	indicate whether AGL is needed
+ *
+ * \retval		0 on success
+ * \retval		negative number upon error
+ */
+static int start_statahead_pattern(struct dentry *parent,
+				   struct ll_statahead_info *sai, bool agl)
+{
+	int node = cfs_cpt_spread_node(cfs_cpt_tab, CFS_CPT_ANY);
+	struct inode *dir = parent->d_inode;
+	struct ll_inode_info *lli = ll_i2info(dir);
+	struct ll_sb_info *sbi = ll_i2sbi(dir);
+	struct task_struct *task;
+	int rc;
+
+	ENTRY;
+
+	spin_lock(&lli->lli_sa_lock);
+	if (lli->lli_sai || (lli->lli_opendir_key &&
+			     lli->lli_opendir_pid != current->pid)) {
+		spin_unlock(&lli->lli_sa_lock);
+		RETURN(-EBUSY);
+	}
+	lli->lli_opendir_key = sai;
+	lli->lli_opendir_pid = current->pid;
+	lli->lli_sa_enabled = 1;
+	lli->lli_sai = sai;
+	spin_unlock(&lli->lli_sa_lock);
+
+	CDEBUG(D_READA, "start statahead thread: [pid %d] [parent %pd] pattern %d\n",
+	       current->pid, parent, sai->sai_pattern);
+
+	task = kthread_create_on_node(ll_statahead_thread, parent, node,
+				      "ll_sa_%u", current->pid);
+	if (IS_ERR(task)) {
+		spin_lock(&lli->lli_sa_lock);
+		lli->lli_sai = NULL;
+		lli->lli_opendir_key = NULL;
+		lli->lli_opendir_pid = 0;
+		lli->lli_sa_enabled = 0;
+		spin_unlock(&lli->lli_sa_lock);
+		rc = PTR_ERR(task);
+		CERROR("can't start ll_sa thread, rc: %d\n", rc);
+		RETURN(rc);
+	}
+
+	if (test_bit(LL_SBI_AGL_ENABLED, sbi->ll_flags) && agl)
+		ll_start_agl(parent, sai);
+
+	atomic_inc(&sbi->ll_sa_total);
+	sai->sai_task = task;
+
+	wake_up_process(task);
+
+	RETURN(0);
+}
+
 /*
  * Check whether statahead for @dir was started.
  */
@@ -1793,3 +2015,170 @@ int ll_revalidate_statahead(struct inode *dir, struct dentry **dentryp,
 	}
 	return rc;
 }
+
+/**
+ * Detect names with an increasing numeric suffix, like "out.000001",
+ * "out.000002", stat'ed in order without reading the directory, and start
+ * statahead for the names following them.
+ *
+ * \param[in] dir	parent directory
+ * \param[in] dentry	dentry just stat'ed
+ * \param[in] agl	whether start the agl thread
+ */
+void ll_statahead_fname_check(struct inode *dir, struct dentry *dentry,
+			      bool agl)
+{
+	struct ll_sb_info *sbi = ll_i2sbi(dir);
+	struct ll_inode_info *lli = ll_i2info(dir);
+	struct ll_statahead_info *sai = NULL;
+	const char *name = dentry->d_name.name;
+	int len = dentry->d_name.len;
+	int prefix = len;
+	unsigned int hash;
+	__u64 index = 0;
+	bool start = false;
+	int rc = 0;
+	int i;
+
+	ENTRY;
+
+	if (!test_bit(LL_SBI_STATAHEAD_FNAME, sbi->ll_flags) ||
+	    sbi->ll_sa_max == 0)
+		RETURN_EXIT;
+
+	while (prefix > 0 && isdigit(name[prefix - 1]))
+		prefix--;
+	/* no numeric suffix, or it doesn't fit in __u64 */
+	if (prefix == len || len - prefix > 19)
+		RETURN_EXIT;
+
+	for (i = prefix; i < len; i++)
+		index = index * 10 + name[i] - '0';
+	hash = ll_full_name_hash(dentry->d_parent, name, prefix);
+
+	spin_lock(&lli->lli_sa_lock);
+	if (lli->lli_sai) {
+		spin_unlock(&lli->lli_sa_lock);
+		RETURN_EXIT;
+	}
+	if (hash == lli->lli_sa_fname_hash &&
+	    index == lli->lli_sa_fname_index + 1) {
+		if (++lli->lli_sa_fname_count >= LL_SA_FNAME_MATCH) {
+			lli->lli_sa_fname_count = 0;
+			start = true;
+		}
+	} else {
+		lli->lli_sa_fname_count = 0;
+	}
+	lli->lli_sa_fname_hash = hash;
+	lli->lli_sa_fname_index = index;
+	spin_unlock(&lli->lli_sa_lock);
+
+	if (!start)
+		RETURN_EXIT;
+
+	if (unlikely(atomic_inc_return(&sbi->ll_sa_running) >
+		     sbi->ll_sa_running_max))
+		GOTO(out, rc = -EMFILE);
+
+	sai = ll_sai_alloc(dentry->d_parent);
+	if (!sai)
+		GOTO(out, rc = -ENOMEM);
+
+	sai->sai_pattern = LSA_PATTERN_FNAME;
+	sai->sai_fname_index = index + 1;
+	sai->sai_fname_prefix = prefix;
+	/* keep the width of zero padded suffixes */
+	if (name[prefix] == '0' && len - prefix > 1)
+		sai->sai_fname_width = len - prefix;
+	memcpy(sai->sai_fname, name, prefix);
+
+	rc = start_statahead_pattern(dentry->d_parent, sai, agl);
+	EXIT;
+out:
+	if (rc < 0) {
+		CDEBUG(D_READA, "%s: can't statahead %.*s* in "DFID": rc = %d\n",
+		       sbi->ll_fsname, prefix, name, PFID(ll_inode2fid(dir)),
+		       rc);
+		if (sai)
+			ll_sai_free(sai);
+		atomic_dec(&sbi->ll_sa_running);
+	}
+}
+
+/**
+ * Start statahead for the names or FIDs given by userspace, for the current
+ * process to stat them later.
+ *
+ * \param[in] file	directory, ".lustre/fid" for a list of FIDs
+ * \param[in] ulist	list of entries
+ *
+ * \retval		0 on success
+ * \retval		negative number upon error
+ */
+int ll_ioc_statahead(struct file *file, struct ll_statahead_list __user *ulist)
+{
+	struct dentry *parent = file_dentry(file);
+	struct inode *dir = file_inode(file);
+	struct ll_sb_info *sbi = ll_i2sbi(dir);
+	struct ll_statahead_info *sai = NULL;
+	struct ll_statahead_list *list = NULL;
+	struct ll_statahead_list hdr;
+	size_t size = 0;
+	int rc;
+
+	ENTRY;
+
+	if (copy_from_user(&hdr, ulist, sizeof(hdr)))
+		RETURN(-EFAULT);
+
+	if (hdr.sal_count == 0 || hdr.sal_size > LL_SA_LIST_MAX_SIZE ||
+	    (hdr.sal_flags & ~LL_SA_LIST_FID))
+		RETURN(-EINVAL);
+
+	if (hdr.sal_flags & LL_SA_LIST_FID) {
+		if (!fid_is_obf(ll_inode2fid(dir)))
+			RETURN(-EINVAL);
+		if (hdr.sal_count > hdr.sal_size / sizeof(struct lu_fid))
+			RETURN(-EINVAL);
+	}
+
+	if (sbi->ll_sa_max == 0)
+		RETURN(-EOPNOTSUPP);
+
+	if (unlikely(atomic_inc_return(&sbi->ll_sa_running) >
+		     sbi->ll_sa_running_max))
+		GOTO(out, rc = -EMFILE);
+
+	size = offsetof(struct ll_statahead_list, sal_buf[hdr.sal_size]);
+	OBD_ALLOC_LARGE(list, size);
+	if (!list)
+		GOTO(out, rc = -ENOMEM);
+
+	if (copy_from_user(list, ulist, size))
+		GOTO(out, rc = -EFAULT);
+	/* the list may have changed since the header was read */
+	*list = hdr;
+
+	sai = ll_sai_alloc(parent);
+	if (!sai)
+		GOTO(out, rc = -ENOMEM);
+
+	sai->sai_pattern = LSA_PATTERN_LIST;
+	sai->sai_list = list;
+	sai->sai_list_size = size;
+	list = NULL;
+
+	rc = start_statahead_pattern(parent, sai, true);
+	EXIT;
+out:
+	if (rc < 0) {
+		if (sai)
+			ll_sai_free(sai);
+		atomic_dec(&sbi->ll_sa_running);
+	}
+	if (list)
+		OBD_FREE_LARGE(list, size);
+
+	return rc;
+}
@@ -572,7 +572,7 @@ static int vvp_io_rw_lock(const struct lu_env *env, struct cl_io *io,
 			io->ci_dio_lock = 1;
 
 		if (ll_file_nolock(vio->vui_fd->fd_file) ||
-		    (vio->vui_fd->fd_file->f_flags & O_DIRECT &&
+		    (ll_io_is_direct(vio->vui_fd->fd_file, io) &&
 		     !io->ci_dio_lock))
 			ast_flags |= CEF_NEVER;
 	}
@@ -837,7 +837,7 @@ static int vvp_io_read_start(const struct lu_env *env,
 	if (!can_populate_pages(env, io, inode))
 		RETURN(0);
 
-	if (!(file->f_flags & O_DIRECT)) {
+	if (!ll_io_is_direct(file, io)) {
 		result = cl_io_lru_reserve(env, io, pos, cnt);
 		if (result)
 			RETURN(result);
@@ -1308,7 +1308,7 @@ static int vvp_io_write_start(const struct lu_env *env,
 	if (OBD_FAIL_CHECK(OBD_FAIL_LLITE_IMUTEX_NOSEC) && lock_inode)
 		RETURN(-EINVAL);
 
-	if (!(file->f_flags & O_DIRECT)) {
+	if (!ll_io_is_direct(file, io)) {
 		result = cl_io_lru_reserve(env, io, pos, cnt);
 		if (result)
 			RETURN(result);
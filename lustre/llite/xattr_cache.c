@@ -297,6 +297,7 @@ static int ll_xattr_cache_destroy_locked(struct ll_inode_info *lli)
 
 	clear_bit(LLIF_XATTR_CACHE_FILLED, &lli->lli_flags);
 	clear_bit(LLIF_XATTR_CACHE, &lli->lli_flags);
+	lli->lli_xattrs_version = 0;
 
 	RETURN(0);
 }
@@ -315,16 +316,38 @@ int ll_xattr_cache_destroy(struct inode *inode)
 	RETURN(rc);
 }
 
+/* free all cached xattrs but the encryption context */
+static void ll_xattr_cache_empty_locked(struct inode *inode)
+{
+	struct ll_inode_info *lli = ll_i2info(inode);
+	struct ll_xattr_entry *entry, *n;
+
+	list_for_each_entry_safe(entry, n, &lli->lli_xattrs, xe_list) {
+		if (strcmp(entry->xe_name, xattr_for_enc(inode)) == 0)
+			continue;
+
+		CDEBUG(D_CACHE, "delete: %s\n", entry->xe_name);
+		list_del(&entry->xe_list);
+		OBD_FREE(entry->xe_name, entry->xe_namelen);
+		OBD_FREE(entry->xe_value, entry->xe_vallen);
+		OBD_SLAB_FREE_PTR(entry, xattr_kmem);
+	}
+	lli->lli_xattrs_version = 0;
+}
+
 /**
  * ll_xattr_cache_empty - empty xattr cache for @ino
  *
  * Similar to ll_xattr_cache_destroy(), but preserves encryption context.
  * So only LLIF_XATTR_CACHE_FILLED flag is cleared, but not LLIF_XATTR_CACHE.
+ *
+ * If the MDT gave a version for the cached xattrs, they are kept but no longer
+ * trusted, the next refill revalidates them against the MDT version instead of
+ * fetching them all again.
  */
 int ll_xattr_cache_empty(struct inode *inode)
 {
 	struct ll_inode_info *lli = ll_i2info(inode);
-	struct ll_xattr_entry *entry, *n;
 
 	ENTRY;
 
@@ -333,16 +356,8 @@ int ll_xattr_cache_empty(struct inode *inode)
 	    !ll_xattr_cache_filled(lli))
 		GOTO(out_empty, 0);
 
-	list_for_each_entry_safe(entry, n, &lli->lli_xattrs, xe_list) {
-		if (strcmp(entry->xe_name, xattr_for_enc(inode)) == 0)
-			continue;
-
-		CDEBUG(D_CACHE, "delete: %s\n", entry->xe_name);
-		list_del(&entry->xe_list);
-		OBD_FREE(entry->xe_name, entry->xe_namelen);
-		OBD_FREE(entry->xe_value, entry->xe_vallen);
-		OBD_SLAB_FREE_PTR(entry, xattr_kmem);
-	}
+	if (lli->lli_xattrs_version == 0)
+		ll_xattr_cache_empty_locked(inode);
 	clear_bit(LLIF_XATTR_CACHE_FILLED, &lli->lli_flags);
 
 out_empty:
@@ -399,7 +414,10 @@ static int ll_xattr_find_get_lock(struct inode *inode,
 		RETURN(PTR_ERR(op_data));
 	}
 
-	op_data->op_valid = OBD_MD_FLXATTR | OBD_MD_FLXATTRLS;
+	op_data->op_valid = OBD_MD_FLXATTR | OBD_MD_FLXATTRLS |
+			    OBD_MD_FLXATTRVER;
+	/* stable under lli_xattrs_enq_lock, only changed by a refill */
+	op_data->op_data_version = lli->lli_xattrs_version;
 
 	rc = md_intent_lock(exp, op_data, oit, req, &ll_md_blocking_ast, 0);
 	ll_finish_md_op_data(op_data);
@@ -468,6 +486,19 @@ static int ll_xattr_cache_refill(struct inode *inode)
 		CERROR("no MDT BODY in the refill xattr reply\n");
 		GOTO(err_cancel, rc = -EPROTO);
 	}
+
+	/* xattrs kept on lock cancel are still valid, reuse them */
+	if (lli->lli_xattrs_version != 0 &&
+	    body->mbo_valid & OBD_MD_FLXATTRVER &&
+	    body->mbo_version == lli->lli_xattrs_version &&
+	    body->mbo_eadatasize == 0 && body->mbo_max_mdsize == 0) {
+		CDEBUG(D_CACHE, "xattrs of "DFID" not modified, version %#llx\n",
+		       PFID(ll_inode2fid(inode)), lli->lli_xattrs_version);
+		ll_stats_ops_tally(sbi, LPROC_LL_GETXATTR_REVALIDATED, 1);
+		set_bit(LLIF_XATTR_CACHE_FILLED, &lli->lli_flags);
+		GOTO(out, rc = 0);
+	}
+
 	/* do not need swab xattr data */
 	xdata = req_capsule_server_sized_get(&req->rq_pill, &RMF_EADATA,
 						body->mbo_eadatasize);
@@ -488,6 +519,9 @@ static int ll_xattr_cache_refill(struct inode *inode)
 
 	if (!ll_xattr_cache_valid(lli))
 		ll_xattr_cache_init(lli);
+	else
+		/* drop the outdated xattrs kept by ll_xattr_cache_empty() */
+		ll_xattr_cache_empty_locked(inode);
 
 	for (i = 0; i < body->mbo_max_mdsize; i++) {
 		CDEBUG(D_CACHE, "caching [%s]=%.*s\n", xdata, *xsizes, xval);
@@ -526,11 +560,15 @@ static int ll_xattr_cache_refill(struct inode *inode)
 		xsizes++;
 	}
 
-	if (xdata != xtail || xval != xvtail)
+	if (xdata != xtail || xval != xvtail) {
 		CERROR("a hole in xattr data\n");
-	else
+	} else {
 		set_bit(LLIF_XATTR_CACHE_FILLED, &lli->lli_flags);
+		if (body->mbo_valid & OBD_MD_FLXATTRVER)
+			lli->lli_xattrs_version = body->mbo_version;
+	}
 
+out:
 	ll_set_lock_data(sbi->ll_md_exp, inode, &oit, NULL);
 	ll_intent_drop_lock(&oit);
 
@@ -3690,23 +3690,28 @@ static int lmv_intent_getattr_async(struct obd_export *exp,
 
 	ENTRY;
 
-	if (!fid_is_sane(&op_data->op_fid2))
+	/* FID is unknown if statahead is not driven by readdir, the reply
+	 * tells whether the object is remote
+	 */
+	if (!fid_is_zero(&op_data->op_fid2) && !fid_is_sane(&op_data->op_fid2))
 		RETURN(-EINVAL);
 
 	ptgt = lmv_locate_tgt(lmv, op_data);
 	if (IS_ERR(ptgt))
 		RETURN(PTR_ERR(ptgt));
 
-	ctgt = lmv_fid2tgt(lmv, &op_data->op_fid2);
-	if (IS_ERR(ctgt))
-		RETURN(PTR_ERR(ctgt));
+	if (!fid_is_zero(&op_data->op_fid2)) {
+		ctgt = lmv_fid2tgt(lmv, &op_data->op_fid2);
+		if (IS_ERR(ctgt))
+			RETURN(PTR_ERR(ctgt));
 
-	/*
-	 * remote object needs two RPCs to lookup and getattr, considering the
-	 * complexity don't support statahead for now.
-	 */
-	if (ctgt != ptgt)
-		RETURN(-EREMOTE);
+		/*
+		 * remote object needs two RPCs to lookup and getattr,
+		 * considering the complexity don't support statahead for now.
+		 */
+		if (ctgt != ptgt)
+			RETURN(-EREMOTE);
+	}
 
 	rc = md_intent_getattr_async(ptgt->ltd_exp, minfo);
 
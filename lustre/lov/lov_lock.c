@@ -250,6 +250,9 @@ static int lov_lock_enqueue(const struct lu_env *env,
 {
 	struct cl_lock *lock = slice->cls_lock;
 	struct lov_lock *lovlck = cl2lov_lock(slice);
+	bool speculative = lock->cll_descr.cld_enq_flags & CEF_SPECULATIVE;
+	bool enqueued = false;
+	int matched = 0;
 	int i;
 	int rc = 0;
 
@@ -267,11 +270,23 @@ static int lov_lock_enqueue(const struct lu_env *env,
 
 		rc = cl_lock_enqueue(subenv->lse_env, subenv->lse_io,
 				     &lls->sub_lock, anchor);
+		/* a speculative request for a stripe already holding a lock
+		 * is not sent, the other stripes may still need theirs */
+		if (speculative && (rc == -EEXIST || rc == -ECANCELED)) {
+			if (matched != -ECANCELED)
+				matched = rc;
+			rc = 0;
+			continue;
+		}
 		if (rc != 0)
 			break;
 
 		lls->sub_is_enqueued = 1;
+		enqueued = true;
 	}
+	/* report a match only if no stripe was requested */
+	if (rc == 0 && !enqueued)
+		rc = matched;
 	RETURN(rc);
 }
 
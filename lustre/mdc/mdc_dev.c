@@ -1380,6 +1380,7 @@ int mdc_io_init(const struct lu_env *env, struct cl_object *obj,
 	struct osc_io *oio = osc_env_io(env);
 
 	CL_IO_SLICE_CLEAN(oio, oi_cl);
+	INIT_LIST_HEAD(&oio->oi_active_pages);
 	cl_io_slice_add(io, &oio->oi_cl, obj, &mdc_io_ops);
 	return 0;
 }
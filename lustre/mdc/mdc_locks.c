@@ -494,6 +494,13 @@ mdc_intent_getxattr_pack(struct obd_export *exp, struct lookup_intent *it,
 	/* pack the intended request */
 	mdc_pack_body(&req->rq_pill, &op_data->op_fid1, op_data->op_valid,
 		      ea_vals_buf_size, -1, 0);
+	/* version of the xattrs cached by the client, if any */
+	if (op_data->op_valid & OBD_MD_FLXATTRVER) {
+		struct mdt_body *body;
+
+		body = req_capsule_client_get(&req->rq_pill, &RMF_MDT_BODY);
+		body->mbo_version = op_data->op_data_version;
+	}
 
 	/* get SELinux policy info if any */
 	mdc_file_sepol_pack(&req->rq_pill);
@@ -1516,6 +1516,9 @@ static int mdc_read_page(struct obd_export *exp, struct md_op_data *op_data,
 		GOTO(hash_collision, page);
 	}
 
+	if (mrinfo->mr_cached_only)
+		GOTO(out_unlock, rc = -ENODATA);
+
 	rp_param.rp_exp = exp;
 	rp_param.rp_mod = op_data;
 	page = ll_read_cache_page(mapping,
@@ -168,6 +168,32 @@ out:
 	RETURN(rc);
 }
 
+/* bits of the xattr version returned to clients counted by the OSD */
+#define MDT_XATTR_VERSION_BITS	40
+
+/*
+ * Version of the xattrs of the object, returned to and checked for clients.
+ * The OSD counts versions from each start of the target, the mount count of
+ * the target in the high bits keeps them unique across restarts and failover,
+ * whatever the clocks of the servers. The mount count is stored on disk before
+ * any update of this mount, so it can't go back while xattrs changed under it.
+ *
+ * 
+etval	0 if there is no usable version, the xattrs are sent again
+ */
+static __u64 mdt_xattr_version(struct mdt_thread_info *info)
+{
+	struct obd_device *obd = mdt2obd_dev(info->mti_mdt);
+	__u64 version;
+
+	version = dt_xattr_version_get(info->mti_env,
+				       mdt_obj2dt(info->mti_object));
+	if (version == 0 || version >= BIT_ULL(MDT_XATTR_VERSION_BITS))
+		return 0;
+
+	return obd->u.obt.obt_mount_count << MDT_XATTR_VERSION_BITS | version;
+}
+
 static int mdt_getxattr_all(struct mdt_thread_info *info,
 			    struct mdt_body *reqbody, struct mdt_body *repbody,
 			    struct lu_buf *buf, struct md_object *next)
@@ -188,6 +214,22 @@ static int mdt_getxattr_all(struct mdt_thread_info *info,
 
 	eadatahead = buf->lb_buf;
 
+	/* the client has the xattrs cached already, reply "not modified" if
+	 * none was updated since, without reading them */
+	if (reqbody->mbo_valid & OBD_MD_FLXATTRVER &&
+	    !mdt_object_remote(info->mti_object)) {
+		__u64 version = mdt_xattr_version(info);
+
+		if (version != 0) {
+			repbody->mbo_valid |= OBD_MD_FLXATTRVER;
+			repbody->mbo_version = version;
+			if (version == reqbody->mbo_version) {
+				eadatasize = 0;
+				GOTO(out_shrink, rc = 0);
+			}
+		}
+	}
+
 	/* Fill out EADATA first */
 	rc = mo_xattr_list(env, next, buf);
 	if (rc < 0)
@@ -584,6 +626,7 @@ int mdt_reint_setxattr(struct mdt_thread_info *info,
 		    strcmp(xattr_name, XATTR_NAME_LINK) == 0 ||
 		    strcmp(xattr_name, XATTR_NAME_FID) == 0 ||
 		    strcmp(xattr_name, XATTR_NAME_VERSION) == 0 ||
+		    strcmp(xattr_name, XATTR_NAME_XATTR_VERSION) == 0 ||
 		    strcmp(xattr_name, XATTR_NAME_SOM) == 0 ||
 		    strcmp(xattr_name, XATTR_NAME_HSM) == 0 ||
 		    strcmp(xattr_name, XATTR_NAME_LFSCK_NAMESPACE) == 0)
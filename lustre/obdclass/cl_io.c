@@ -732,6 +732,29 @@ int cl_io_submit_sync(const struct lu_env *env, struct cl_io *io,
 }
 EXPORT_SYMBOL(cl_io_submit_sync);
 
+/**
+ * Accounts the time since \a start to the latency histogram of \a stage,
+ * and returns the current time, which is the start of the next stage.
+ * Only reads and writes are accounted, other IO types are much cheaper and
+ * would hide their latency.
+ */
+static ktime_t cl_io_stage_tally(const struct cl_io *io,
+				 enum cl_io_stage stage, ktime_t start)
+{
+	struct cl_site *site;
+	ktime_t now;
+
+	if (io->ci_type != CIT_READ && io->ci_type != CIT_WRITE)
+		return start;
+
+	site = cl_object_site(io->ci_obj);
+	now = ktime_get();
+
+	lprocfs_oh_tally_log2_pcpu(&site->cs_io_hist[stage],
+				   ktime_us_delta(now, start));
+	return now;
+}
+
 /**
  * Main io loop.
  *
@@ -749,7 +772,8 @@ EXPORT_SYMBOL(cl_io_submit_sync);
  *
  *    - cl_io_iter_fini()
  *
- * repeatedly until there is no more io to do.
+ * repeatedly until there is no more io to do. For reads and writes, the
+ * latency of the first four is accounted in cl_site::cs_io_hist.
  */
 int cl_io_loop(const struct lu_env *env, struct cl_io *io)
 {
@@ -760,13 +784,17 @@ int cl_io_loop(const struct lu_env *env, struct cl_io *io)
 	ENTRY;
 
 	do {
+		ktime_t kstart = ktime_get();
 		size_t nob;
 
 		io->ci_continue = 0;
 		result = cl_io_iter_init(env, io);
+		kstart = cl_io_stage_tally(io, CL_IO_STAGE_ITER_INIT, kstart);
 		if (result == 0) {
 			nob    = io->ci_nob;
 			result = cl_io_lock(env, io);
+			kstart = cl_io_stage_tally(io, CL_IO_STAGE_LOCK,
+						   kstart);
 			if (result == 0) {
 				/*
 				 * Notify layers that locks has been taken,
@@ -776,6 +804,9 @@ int cl_io_loop(const struct lu_env *env, struct cl_io *io)
 				 *   - llite: generic_file_read();
 				 */
 				result = cl_io_start(env, io);
+				kstart = cl_io_stage_tally(io,
+							   CL_IO_STAGE_START,
+							   kstart);
 				/*
 				 * Send any remaining pending
 				 * io, etc.
@@ -783,6 +814,7 @@ int cl_io_loop(const struct lu_env *env, struct cl_io *io)
 				 **   - llite: ll_rw_stats_tally.
 				 */
 				cl_io_end(env, io);
+				cl_io_stage_tally(io, CL_IO_STAGE_END, kstart);
 				cl_io_unlock(env, io);
 				cl_io_rw_advance(env, io, io->ci_nob - nob);
 			}
@@ -1247,8 +1279,12 @@ static void cl_sub_dio_end(const struct lu_env *env, struct cl_sync_io *anchor)
 		cl_page_list_del(env, &sdio->csd_pages, page);
 	}
 
-	ll_release_user_pages(sdio->csd_dio_pages.ldp_pages,
-			      sdio->csd_dio_pages.ldp_count);
+	/* bounce pages are copied out and freed by the creator, which always
+	 * waits for an unaligned sub-dio to complete
+	 */
+	if (!sdio->csd_unaligned)
+		ll_release_user_pages(sdio->csd_dio_pages.ldp_pages,
+				      sdio->csd_dio_pages.ldp_count);
 	cl_sync_io_note(env, &sdio->csd_ll_aio->cda_sync, ret);
 
 	EXIT;
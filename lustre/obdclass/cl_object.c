@@ -491,13 +491,47 @@ int cl_site_init(struct cl_site *s, struct cl_device *d)
         int result;
 
         result = lu_site_init(&s->cs_lu, &d->cd_lu_dev);
-        if (result == 0) {
-                cache_stats_init(&s->cs_pages, "pages");
-                for (i = 0; i < ARRAY_SIZE(s->cs_pages_state); ++i)
-			atomic_set(&s->cs_pages_state[0], 0);
-		cl_env_percpu_refill();
+	if (result)
+		return result;
+
+	cache_stats_init(&s->cs_pages, "pages");
+	for (i = 0; i < ARRAY_SIZE(s->cs_pages_state); ++i)
+		atomic_set(&s->cs_pages_state[0], 0);
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+#ifdef HAVE_PERCPU_COUNTER_INIT_GFP_FLAG
+	result = percpu_counter_init(&s->cs_page_count, 0, GFP_NOFS);
+#else
+	result = percpu_counter_init(&s->cs_page_count, 0);
+#endif
+	if (result)
+		goto out_site;
+#ifdef HAVE_PERCPU_COUNTER_INIT_GFP_FLAG
+	result = percpu_counter_init(&s->cs_page_bytes, 0, GFP_NOFS);
+#else
+	result = percpu_counter_init(&s->cs_page_bytes, 0);
+#endif
+	if (result)
+		goto out_count;
+#endif
+	for (i = 0; i < ARRAY_SIZE(s->cs_io_hist); i++) {
+		result = lprocfs_oh_alloc_pcpu(&s->cs_io_hist[i]);
+		if (result)
+			goto out_hist;
 	}
-	return result;
+	cl_env_percpu_refill();
+	return 0;
+
+out_hist:
+	while (i-- > 0)
+		lprocfs_oh_release_pcpu(&s->cs_io_hist[i]);
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	percpu_counter_destroy(&s->cs_page_bytes);
+out_count:
+	percpu_counter_destroy(&s->cs_page_count);
+out_site:
+#endif
+	lu_site_fini(&s->cs_lu);
+	return -ENOMEM;
 }
 EXPORT_SYMBOL(cl_site_init);
 
@@ -506,6 +540,14 @@ EXPORT_SYMBOL(cl_site_init);
  */
 void cl_site_fini(struct cl_site *s)
 {
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(s->cs_io_hist); i++)
+		lprocfs_oh_release_pcpu(&s->cs_io_hist[i]);
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	percpu_counter_destroy(&s->cs_page_bytes);
+	percpu_counter_destroy(&s->cs_page_count);
+#endif
         lu_site_fini(&s->cs_lu);
 }
 EXPORT_SYMBOL(cl_site_fini);
@@ -519,7 +561,7 @@ static struct cache_stats cl_env_stats = {
  * Outputs client site statistical counters into a buffer. Suitable for
  * ll_rd_*()-style functions.
  */
-int cl_site_stats_print(const struct cl_site *site, struct seq_file *m)
+int cl_site_stats_print(struct cl_site *site, struct seq_file *m)
 {
 	static const char *const pstate[] = {
 		[CPS_CACHED]	= "c",
@@ -528,6 +570,10 @@ int cl_site_stats_print(const struct cl_site *site, struct seq_file *m)
 		[CPS_PAGEIN]	= "r",
 		[CPS_FREEING]	= "f"
 	};
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	u64 pages;
+	u64 bytes;
+#endif
 	size_t i;
 
 /*
@@ -535,6 +581,7 @@ int cl_site_stats_print(const struct cl_site *site, struct seq_file *m)
 pages: ...... ...... ...... ...... ...... [...... ...... ...... ......]
 locks: ...... ...... ...... ...... ...... [...... ...... ...... ...... ......]
   env: ...... ...... ...... ...... ......
+page_memory: ...... pages ...... bytes ...... bytes/GiB cached
  */
 	lu_site_stats_seq_print(&site->cs_lu, m);
 	cache_stats_print(&site->cs_pages, m, 1);
@@ -545,6 +592,14 @@ locks: ...... ...... ...... ...... ...... [...... ...... ...... ...... ......]
 	seq_printf(m, "]\n");
 	cache_stats_print(&cl_env_stats, m, 0);
 	seq_printf(m, "\n");
+
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	pages = percpu_counter_sum_positive(&site->cs_page_count);
+	bytes = percpu_counter_sum_positive(&site->cs_page_bytes);
+	seq_printf(m, "page_memory: %llu pages %llu bytes %llu bytes/GiB cached\n",
+		   pages, bytes, pages ?
+		   div64_u64(bytes << (30 - PAGE_SHIFT), pages) : 0);
+#endif
 	return 0;
 }
 EXPORT_SYMBOL(cl_site_stats_print);
@@ -106,6 +106,26 @@ static void cs_pagestate_dec(const struct cl_object *obj,
 #endif
 }
 
+static void cs_page_mem_add(const struct cl_object *obj, unsigned int bufsize)
+{
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	struct cl_site *site = cl_object_site(obj);
+
+	percpu_counter_inc(&site->cs_page_count);
+	percpu_counter_add(&site->cs_page_bytes, bufsize);
+#endif
+}
+
+static void cs_page_mem_sub(const struct cl_object *obj, unsigned int bufsize)
+{
+#ifdef CONFIG_DEBUG_PAGESTATE_TRACKING
+	struct cl_site *site = cl_object_site(obj);
+
+	percpu_counter_dec(&site->cs_page_count);
+	percpu_counter_sub(&site->cs_page_bytes, bufsize);
+#endif
+}
+
 /**
  * Internal version of cl_page_get().
  *
@@ -206,6 +226,7 @@ static void cl_page_free(const struct lu_env *env, struct cl_page *cl_page,
 	if (cl_page->cp_type != CPT_TRANSIENT)
 		cl_object_put(env, obj);
 	lu_ref_fini(&cl_page->cp_reference);
+	cs_page_mem_sub(obj, bufsize);
 	__cl_page_free(cl_page, bufsize);
 	EXIT;
 }
@@ -285,6 +306,7 @@ struct cl_page *cl_page_alloc(const struct lu_env *env, struct cl_object *o,
 		 */
 		BUILD_BUG_ON((1 << CP_STATE_BITS) < CPS_NR); /* cp_state */
 		BUILD_BUG_ON((1 << CP_TYPE_BITS) < CPT_NR); /* cp_type */
+		cs_page_mem_add(o, cl_object_header(o)->coh_page_bufsize);
 		atomic_set(&cl_page->cp_ref, 1);
 		cl_page->cp_obj = o;
 		if (type != CPT_TRANSIENT)
@@ -332,10 +354,10 @@ struct cl_page *cl_page_alloc(const struct lu_env *env, struct cl_object *o,
  * Returns a cl_page with index \a idx at the object \a o, and associated with
  * the VM page \a vmpage.
  *
- * This is the main entry point into the cl_page caching interface. First, a
- * cache (implemented as a per-object radix tree) is consulted. If page is
- * found there, it is returned immediately. Otherwise new page is allocated
- * and returned. In any case, additional reference to page is acquired.
+ * This is the main entry point into the cl_page caching interface. First, the
+ * VM page is checked for an attached cl_page. If page is found there, it is
+ * returned immediately. Otherwise new page is allocated and returned. In any
+ * case, additional reference to page is acquired.
  *
  * \see cl_object_find(), cl_lock_find()
  */
@@ -344,42 +366,42 @@ struct cl_page *cl_page_find(const struct lu_env *env,
 			     pgoff_t idx, struct page *vmpage,
 			     enum cl_page_type type)
 {
-	struct cl_page          *page = NULL;
-	struct cl_object_header *hdr;
+	struct cl_page *page;
 
 	LASSERT(type == CPT_CACHEABLE || type == CPT_TRANSIENT);
 	might_sleep();
 
 	ENTRY;
 
-	hdr = cl_object_header(o);
 	cs_page_inc(o, CS_lookup);
 
-        CDEBUG(D_PAGE, "%lu@"DFID" %p %lx %d\n",
-               idx, PFID(&hdr->coh_lu.loh_fid), vmpage, vmpage->private, type);
-        /* fast path. */
-        if (type == CPT_CACHEABLE) {
+	/* fast path, the page is usually found for cached IO */
+	if (type == CPT_CACHEABLE) {
 		/* vmpage lock is used to protect the child/parent
 		 * relationship */
 		LASSERT(PageLocked(vmpage));
-                /*
-                 * cl_vmpage_page() can be called here without any locks as
-                 *
-                 *     - "vmpage" is locked (which prevents ->private from
-                 *       concurrent updates), and
-                 *
-                 *     - "o" cannot be destroyed while current thread holds a
-                 *       reference on it.
-                 */
-                page = cl_vmpage_page(vmpage, o);
-		if (page != NULL) {
+		/*
+		 * cl_vmpage_page() can be called here without any locks as
+		 *
+		 *     - "vmpage" is locked (which prevents ->private from
+		 *       concurrent updates), and
+		 *
+		 *     - "o" cannot be destroyed while current thread holds a
+		 *       reference on it.
+		 */
+		page = cl_vmpage_page(vmpage, o);
+		if (likely(page != NULL)) {
 			cs_page_inc(o, CS_hit);
 			RETURN(page);
 		}
-        }
+	}
+
+	CDEBUG(D_PAGE, "%lu@"DFID" %p %lx %d\n", idx,
+	       PFID(&cl_object_header(o)->coh_lu.loh_fid), vmpage,
+	       vmpage->private, type);
 
-        /* allocate and initialize cl_page */
-        page = cl_page_alloc(env, o, idx, vmpage, type);
+	/* allocate and initialize cl_page */
+	page = cl_page_alloc(env, o, idx, vmpage, type);
 	RETURN(page);
 }
 EXPORT_SYMBOL(cl_page_find);
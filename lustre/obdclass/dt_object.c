@@ -558,6 +558,28 @@ dt_obj_version_t dt_version_get(const struct lu_env *env, struct dt_object *o)
 }
 EXPORT_SYMBOL(dt_version_get);
 
+/*
+ * Version of the whole xattr set of \a o, changed by every xattr update of the
+ * object. 0 if the OSD doesn't keep one.
+ */
+__u64 dt_xattr_version_get(const struct lu_env *env, struct dt_object *o)
+{
+	struct lu_buf vbuf;
+	__u64 version;
+	int rc;
+
+	LASSERT(o);
+	vbuf.lb_buf = &version;
+	vbuf.lb_len = sizeof(version);
+	rc = dt_xattr_get(env, o, &vbuf, XATTR_NAME_XATTR_VERSION);
+	if (rc != sizeof(version)) {
+		CDEBUG(D_INODE, "Can't get xattr version, rc %d\n", rc);
+		version = 0;
+	}
+	return version;
+}
+EXPORT_SYMBOL(dt_xattr_version_get);
+
 /* list of all supported index types */
 
 /* directories */
@@ -136,6 +136,84 @@ static ssize_t max_rpcs_in_flight_store(struct kobject *kobj,
 }
 LUSTRE_RW_ATTR(max_rpcs_in_flight);
 
+static ssize_t max_rpcs_in_flight_auto_show(struct kobject *kobj,
+					    struct attribute *attr,
+					    char *buf)
+{
+	struct obd_device *obd = container_of(kobj, struct obd_device,
+					      obd_kset.kobj);
+	struct client_obd *cli = &obd->u.cli;
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", cli->cl_rif_auto);
+}
+
+static ssize_t max_rpcs_in_flight_auto_store(struct kobject *kobj,
+					     struct attribute *attr,
+					     const char *buffer,
+					     size_t count)
+{
+	struct obd_device *obd = container_of(kobj, struct obd_device,
+					      obd_kset.kobj);
+	struct client_obd *cli = &obd->u.cli;
+	bool val;
+	int rc;
+
+	rc = kstrtobool(buffer, &val);
+	if (rc)
+		return rc;
+
+	spin_lock(&cli->cl_loi_list_lock);
+	if (val && !cli->cl_rif_auto) {
+		/* start from the admin setting, and learn the OST from it */
+		cli->cl_rif_limit = cli->cl_max_rpcs_in_flight;
+		cli->cl_rif_acked = 0;
+		cli->cl_rif_rtt_min = 0;
+		cli->cl_rif_rtt_avg = 0;
+	}
+	cli->cl_rif_auto = val;
+	spin_unlock(&cli->cl_loi_list_lock);
+
+	return count;
+}
+LUSTRE_RW_ATTR(max_rpcs_in_flight_auto);
+
+static ssize_t min_rpcs_in_flight_show(struct kobject *kobj,
+				       struct attribute *attr,
+				       char *buf)
+{
+	struct obd_device *obd = container_of(kobj, struct obd_device,
+					      obd_kset.kobj);
+	struct client_obd *cli = &obd->u.cli;
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", cli->cl_rif_min);
+}
+
+static ssize_t min_rpcs_in_flight_store(struct kobject *kobj,
+					struct attribute *attr,
+					const char *buffer,
+					size_t count)
+{
+	struct obd_device *obd = container_of(kobj, struct obd_device,
+					      obd_kset.kobj);
+	struct client_obd *cli = &obd->u.cli;
+	unsigned int val;
+	int rc;
+
+	rc = kstrtouint(buffer, 0, &val);
+	if (rc)
+		return rc;
+
+	if (val == 0 || val > cli->cl_max_rpcs_in_flight)
+		return -ERANGE;
+
+	spin_lock(&cli->cl_loi_list_lock);
+	cli->cl_rif_min = val;
+	spin_unlock(&cli->cl_loi_list_lock);
+
+	return count;
+}
+LUSTRE_RW_ATTR(min_rpcs_in_flight);
+
 static ssize_t max_dirty_mb_show(struct kobject *kobj,
 				 struct attribute *attr,
 				 char *buf)
@@ -188,6 +266,7 @@ static int osc_cached_mb_seq_show(struct seq_file *m, void *v)
 	struct obd_device *obd = m->private;
 	struct client_obd *cli = &obd->u.cli;
 	int shift = 20 - PAGE_SHIFT;
+	int i;
 
 	seq_printf(m, "used_mb: %ld\n"
 		   "busy_cnt: %ld\n"
@@ -197,6 +276,11 @@ static int osc_cached_mb_seq_show(struct seq_file *m, void *v)
 		    atomic_long_read(&cli->cl_lru_busy),
 		   cli->cl_lru_reclaim);
 
+	/* racy read is fine, these are only for statistics */
+	for (i = 0; i < cli->cl_lru_nparts; i++)
+		seq_printf(m, "cpt%d_lru_mb: %ld\n", i,
+			   READ_ONCE(cli->cl_lru_parts[i].clp_in_list) >> shift);
+
 	return 0;
 }
 
@@ -549,6 +633,29 @@ static int osc_unstable_stats_seq_show(struct seq_file *m, void *v)
 }
 LPROC_SEQ_FOPS_RO(osc_unstable_stats);
 
+static int osc_rif_auto_stats_seq_show(struct seq_file *m, void *v)
+{
+	struct obd_device *obd = m->private;
+	struct client_obd *cli = &obd->u.cli;
+
+	spin_lock(&cli->cl_loi_list_lock);
+	seq_printf(m, "enabled:             %u\n"
+		   "rpcs_in_flight:      %u\n"
+		   "bounds:              [%u, %u]\n"
+		   "rtt_min_usec:        %llu\n"
+		   "rtt_avg_usec:        %llu\n"
+		   "increases:           %llu\n"
+		   "decreases:           %llu\n",
+		   cli->cl_rif_auto, osc_rif_limit(cli), cli->cl_rif_min,
+		   cli->cl_max_rpcs_in_flight, cli->cl_rif_rtt_min,
+		   cli->cl_rif_rtt_avg, cli->cl_rif_increases,
+		   cli->cl_rif_decreases);
+	spin_unlock(&cli->cl_loi_list_lock);
+
+	return 0;
+}
+LPROC_SEQ_FOPS_RO(osc_rif_auto_stats);
+
 static ssize_t idle_timeout_show(struct kobject *kobj, struct attribute *attr,
 				 char *buf)
 {
@@ -701,6 +808,8 @@ struct lprocfs_vars lprocfs_osc_obd_vars[] = {
 	  .fops	=	&osc_pinger_recov_fops		},
 	{ .name	=	"unstable_stats",
 	  .fops	=	&osc_unstable_stats_fops	},
+	{ .name	=	"rif_auto_stats",
+	  .fops	=	&osc_rif_auto_stats_fops	},
 	{ NULL }
 };
 
@@ -873,6 +982,8 @@ static struct attribute *osc_attrs[] = {
 	&lustre_attr_grant_shrink_interval.attr,
 	&lustre_attr_max_dirty_mb.attr,
 	&lustre_attr_max_rpcs_in_flight.attr,
+	&lustre_attr_max_rpcs_in_flight_auto.attr,
+	&lustre_attr_min_rpcs_in_flight.attr,
 	&lustre_attr_short_io_bytes.attr,
 	&lustre_attr_resend_count.attr,
 	&lustre_attr_ost_conn_uuid.attr,
@@ -580,6 +580,37 @@ static int osc_extent_merge(const struct lu_env *env, struct osc_extent *cur,
 	return 0;
 }
 
+/**
+ * Add the pages queued by @oio to its active extent, see osc_queue_async_io().
+ */
+static void osc_io_active_flush(struct osc_io *oio)
+{
+	struct osc_extent *ext = oio->oi_active;
+
+	if (oio->oi_active_nr == 0)
+		return;
+
+	osc_object_lock(ext->oe_obj);
+	if (ext->oe_nr_pages == 0)
+		ext->oe_srvlock = oio->oi_active_srvlock;
+	else
+		LASSERT(ext->oe_srvlock == oio->oi_active_srvlock);
+	ext->oe_nr_pages += oio->oi_active_nr;
+	list_splice_tail_init(&oio->oi_active_pages, &ext->oe_pages);
+	osc_object_unlock(ext->oe_obj);
+	oio->oi_active_nr = 0;
+}
+
+/**
+ * Release the active extent of @oio, once its pages are added to it.
+ */
+void osc_io_active_release(const struct lu_env *env, struct osc_io *oio)
+{
+	osc_io_active_flush(oio);
+	osc_extent_release(env, oio->oi_active);
+	oio->oi_active = NULL;
+}
+
 /**
  * Drop user count of osc_extent, and unplug IO asynchronously.
  */
@@ -1633,7 +1664,7 @@ out:
 static int osc_max_rpc_in_flight(struct client_obd *cli, struct osc_object *osc)
 {
 	int hprpc = !!list_empty(&osc->oo_hp_exts);
-	return rpcs_in_flight(cli) >= cli->cl_max_rpcs_in_flight + hprpc;
+	return rpcs_in_flight(cli) >= osc_rif_limit(cli) + hprpc;
 }
 
 /* This maintains the lists of pending pages to read/write for a given object
@@ -2398,8 +2429,7 @@ int osc_queue_async_io(const struct lu_env *env, struct cl_io *io,
 		need_release = 1;
 	}
 	if (need_release) {
-		osc_extent_release(env, ext);
-		oio->oi_active = NULL;
+		osc_io_active_release(env, oio);
 		ext = NULL;
 	}
 
@@ -2450,14 +2480,16 @@ int osc_queue_async_io(const struct lu_env *env, struct cl_io *io,
 			 ext, "index = %lu.\n", index);
 		LASSERT((oap->oap_brw_flags & OBD_BRW_FROM_GRANT) != 0);
 
-		osc_object_lock(osc);
-		if (ext->oe_nr_pages == 0)
-			ext->oe_srvlock = ops->ops_srvlock;
+		/* The extent is active and can't be sent or merged until it
+		 * is released, so keep its new pages in the IO and add them
+		 * all at once then, instead of taking the object lock, that
+		 * all writers of the object contend on, for each page. */
+		if (oio->oi_active_nr == 0)
+			oio->oi_active_srvlock = ops->ops_srvlock;
 		else
-			LASSERT(ext->oe_srvlock == ops->ops_srvlock);
-		++ext->oe_nr_pages;
-		list_add_tail(&oap->oap_pending_item, &ext->oe_pages);
-		osc_object_unlock(osc);
+			LASSERT(oio->oi_active_srvlock == ops->ops_srvlock);
+		++oio->oi_active_nr;
+		list_add_tail(&oap->oap_pending_item, &oio->oi_active_pages);
 
 		if (!ext->oe_layout_version)
 			ext->oe_layout_version = io->ci_layout_version;
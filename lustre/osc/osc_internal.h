@@ -48,6 +48,7 @@ int lru_queue_work(const struct lu_env *env, void *data);
 int osc_extent_finish(const struct lu_env *env, struct osc_extent *ext,
 		      int sent, int rc);
 void osc_extent_release(const struct lu_env *env, struct osc_extent *ext);
+void osc_io_active_release(const struct lu_env *env, struct osc_io *oio);
 int osc_lock_discard_pages(const struct lu_env *env, struct osc_object *osc,
 			   pgoff_t start, pgoff_t end, bool discard);
 
@@ -136,6 +137,16 @@ static inline unsigned long rpcs_in_flight(struct client_obd *cli)
 	return cli->cl_r_in_flight + cli->cl_w_in_flight;
 }
 
+/* limit of BRW RPCs in flight, auto-tuned if cl_rif_auto is set */
+static inline u32 osc_rif_limit(struct client_obd *cli)
+{
+	if (!cli->cl_rif_auto)
+		return cli->cl_max_rpcs_in_flight;
+
+	return min_t(u32, max_t(u32, cli->cl_rif_limit, cli->cl_rif_min),
+		     cli->cl_max_rpcs_in_flight);
+}
+
 static inline char *cli_name(struct client_obd *cli)
 {
 	return cli->cl_import->imp_obd->obd_name;
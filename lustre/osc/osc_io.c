@@ -379,10 +379,8 @@ int osc_io_commit_async(const struct lu_env *env,
 	/* for sync write, kernel will wait for this page to be flushed before
 	 * osc_io_end() is called, so release it earlier.
 	 * for mkwrite(), it's known there is no further pages. */
-	if (cl_io_is_sync_write(io) && oio->oi_active != NULL) {
-		osc_extent_release(env, oio->oi_active);
-		oio->oi_active = NULL;
-	}
+	if (cl_io_is_sync_write(io) && oio->oi_active != NULL)
+		osc_io_active_release(env, oio);
 
 	CDEBUG(D_INFO, "%d %d\n", qin->pl_nr, result);
 	RETURN(result);
@@ -394,10 +392,8 @@ void osc_io_extent_release(const struct lu_env *env,
 {
 	struct osc_io *oio = cl2osc_io(env, ios);
 
-	if (oio->oi_active != NULL) {
-		osc_extent_release(env, oio->oi_active);
-		oio->oi_active = NULL;
-	}
+	if (oio->oi_active != NULL)
+		osc_io_active_release(env, oio);
 }
 EXPORT_SYMBOL(osc_io_extent_release);
 
@@ -1090,10 +1086,8 @@ void osc_io_end(const struct lu_env *env, const struct cl_io_slice *slice)
 {
 	struct osc_io *oio = cl2osc_io(env, slice);
 
-	if (oio->oi_active) {
-		osc_extent_release(env, oio->oi_active);
-		oio->oi_active = NULL;
-	}
+	if (oio->oi_active)
+		osc_io_active_release(env, oio);
 }
 EXPORT_SYMBOL(osc_io_end);
 
@@ -1317,6 +1311,7 @@ int osc_io_init(const struct lu_env *env,
         struct osc_io *oio = osc_env_io(env);
 
         CL_IO_SLICE_CLEAN(oio, oi_cl);
+        INIT_LIST_HEAD(&oio->oi_active_pages);
         cl_io_slice_add(io, &oio->oi_cl, obj, &osc_io_ops);
         return 0;
 }
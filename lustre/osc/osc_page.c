@@ -417,40 +417,83 @@ int lru_queue_work(const struct lu_env *env, void *data)
 	RETURN(0);
 }
 
+/* LRU list partition for the memory node of @opg */
+static inline int osc_lru_part_of(struct client_obd *cli,
+				  struct osc_page *opg)
+{
+	struct page *vmpage = cl_page_vmpage(opg->ops_cl.cpl_page);
+	int cpt = cfs_cpt_of_node(cfs_cpt_tab, page_to_nid(vmpage));
+
+	return cpt >= 0 && cpt < cli->cl_lru_nparts ? cpt : 0;
+}
+
+static inline struct cl_lru_part *osc_lru_part(struct client_obd *cli,
+					       struct osc_page *opg)
+{
+	return &cli->cl_lru_parts[opg->ops_lru_part];
+}
+
+static void osc_lru_add_list(struct client_obd *cli, int cpt,
+			     struct list_head *lru, long npages)
+{
+	struct cl_lru_part *part = &cli->cl_lru_parts[cpt];
+
+	spin_lock(&part->clp_lock);
+	list_splice_tail_init(lru, &part->clp_list);
+	part->clp_in_list += npages;
+	spin_unlock(&part->clp_lock);
+}
+
+/**
+ * Pages of one RPC are likely from the same memory node, so they are
+ * added to the LRU list of that node in runs, one lock round trip each.
+ */
 void osc_lru_add_batch(struct client_obd *cli, struct list_head *plist)
 {
 	LIST_HEAD(lru);
 	struct osc_async_page *oap;
 	long npages = 0;
+	long count = 0;
+	int cpt = 0;
 
 	list_for_each_entry(oap, plist, oap_pending_item) {
 		struct osc_page *opg = oap2osc_page(oap);
+		int pcpt;
 
 		if (!opg->ops_in_lru)
 			continue;
 
+		pcpt = osc_lru_part_of(cli, opg);
+		if (count > 0 && pcpt != cpt) {
+			osc_lru_add_list(cli, cpt, &lru, count);
+			count = 0;
+		}
+		cpt = pcpt;
+
+		++count;
 		++npages;
 		LASSERT(list_empty(&opg->ops_lru));
-		list_add(&opg->ops_lru, &lru);
+		opg->ops_lru_part = cpt;
+		list_add_tail(&opg->ops_lru, &lru);
 	}
 
 	if (npages > 0) {
-		spin_lock(&cli->cl_lru_list_lock);
-		list_splice_tail(&lru, &cli->cl_lru_list);
+		osc_lru_add_list(cli, cpt, &lru, count);
 		atomic_long_sub(npages, &cli->cl_lru_busy);
 		atomic_long_add(npages, &cli->cl_lru_in_list);
 		cli->cl_lru_last_used = ktime_get_real_seconds();
-		spin_unlock(&cli->cl_lru_list_lock);
 
 		if (waitqueue_active(&osc_lru_waitq))
 			(void)ptlrpcd_queue_work(cli->cl_lru_work);
 	}
 }
 
+/* called with clp_lock of the page's LRU partition held */
 static void __osc_lru_del(struct client_obd *cli, struct osc_page *opg)
 {
 	LASSERT(atomic_long_read(&cli->cl_lru_in_list) > 0);
 	list_del_init(&opg->ops_lru);
+	osc_lru_part(cli, opg)->clp_in_list--;
 	atomic_long_dec(&cli->cl_lru_in_list);
 }
 
@@ -461,14 +504,16 @@ static void __osc_lru_del(struct client_obd *cli, struct osc_page *opg)
 static void osc_lru_del(struct client_obd *cli, struct osc_page *opg)
 {
 	if (opg->ops_in_lru) {
-		spin_lock(&cli->cl_lru_list_lock);
+		struct cl_lru_part *part = osc_lru_part(cli, opg);
+
+		spin_lock(&part->clp_lock);
 		if (!list_empty(&opg->ops_lru)) {
 			__osc_lru_del(cli, opg);
 		} else {
 			LASSERT(atomic_long_read(&cli->cl_lru_busy) > 0);
 			atomic_long_dec(&cli->cl_lru_busy);
 		}
-		spin_unlock(&cli->cl_lru_list_lock);
+		spin_unlock(&part->clp_lock);
 
 		atomic_long_inc(cli->cl_lru_left);
 		/* this is a great place to release more LRU pages if
@@ -492,14 +537,17 @@ static void osc_lru_use(struct client_obd *cli, struct osc_page *opg)
 	/* If page is being transferred for the first time,
 	 * ops_lru should be empty */
 	if (opg->ops_in_lru) {
+		struct cl_lru_part *part;
+
 		if (list_empty(&opg->ops_lru))
 			return;
-		spin_lock(&cli->cl_lru_list_lock);
+		part = osc_lru_part(cli, opg);
+		spin_lock(&part->clp_lock);
 		if (!list_empty(&opg->ops_lru)) {
 			__osc_lru_del(cli, opg);
 			atomic_long_inc(&cli->cl_lru_busy);
 		}
-		spin_unlock(&cli->cl_lru_list_lock);
+		spin_unlock(&part->clp_lock);
 	}
 }
 
@@ -557,9 +605,11 @@ long osc_lru_shrink(const struct lu_env *env, struct client_obd *cli,
 	struct cl_page **pvec;
 	struct osc_page *opg;
 	long count = 0;
-	int maxscan = 0;
+	long maxscan = 0;
 	int index = 0;
+	int cpt;
 	int rc = 0;
+	int i;
 	ENTRY;
 
 	LASSERT(atomic_long_read(&cli->cl_lru_in_list) >= 0);
@@ -583,91 +633,105 @@ long osc_lru_shrink(const struct lu_env *env, struct client_obd *cli,
 	pvec = (struct cl_page **)osc_env_info(env)->oti_pvec;
 	io = osc_env_thread_io(env);
 
-	spin_lock(&cli->cl_lru_list_lock);
 	if (force)
 		cli->cl_lru_reclaim++;
-	maxscan = min(target << 1, atomic_long_read(&cli->cl_lru_in_list));
-	while (!list_empty(&cli->cl_lru_list)) {
-		struct cl_page *page;
-		bool will_free = false;
+	/* start from the partition local to this thread */
+	cpt = cfs_cpt_current(cfs_cpt_tab, 0);
+	if (cpt < 0 || cpt >= cli->cl_lru_nparts)
+		cpt = 0;
+	for (i = 0; i < cli->cl_lru_nparts && count < target && rc == 0;
+	     i++) {
+		struct cl_lru_part *part;
+
+		part = &cli->cl_lru_parts[(cpt + i) % cli->cl_lru_nparts];
+		spin_lock(&part->clp_lock);
+		maxscan = min((target - count) << 1, part->clp_in_list);
+		while (!list_empty(&part->clp_list)) {
+			struct cl_page *page;
+			bool will_free = false;
+
+			if (!force && atomic_read(&cli->cl_lru_shrinkers) > 1)
+				break;
 
-		if (!force && atomic_read(&cli->cl_lru_shrinkers) > 1)
-			break;
+			if (--maxscan < 0)
+				break;
 
-		if (--maxscan < 0)
-			break;
+			opg = list_first_entry(&part->clp_list,
+					       struct osc_page, ops_lru);
+			page = opg->ops_cl.cpl_page;
+			if (lru_page_busy(cli, page)) {
+				list_move_tail(&opg->ops_lru, &part->clp_list);
+				continue;
+			}
 
-		opg = list_first_entry(&cli->cl_lru_list, struct osc_page,
-				       ops_lru);
-		page = opg->ops_cl.cpl_page;
-		if (lru_page_busy(cli, page)) {
-			list_move_tail(&opg->ops_lru, &cli->cl_lru_list);
-			continue;
-		}
+			LASSERT(page->cp_obj != NULL);
+			if (clobj != page->cp_obj) {
+				struct cl_object *tmp = page->cp_obj;
 
-		LASSERT(page->cp_obj != NULL);
-		if (clobj != page->cp_obj) {
-			struct cl_object *tmp = page->cp_obj;
+				cl_object_get(tmp);
+				spin_unlock(&part->clp_lock);
 
-			cl_object_get(tmp);
-			spin_unlock(&cli->cl_lru_list_lock);
+				if (clobj != NULL) {
+					discard_pagevec(env, io, pvec, index);
+					index = 0;
 
-			if (clobj != NULL) {
-				discard_pagevec(env, io, pvec, index);
-				index = 0;
+					cl_io_fini(env, io);
+					cl_object_put(env, clobj);
+					clobj = NULL;
+				}
 
-				cl_io_fini(env, io);
-				cl_object_put(env, clobj);
-				clobj = NULL;
-			}
+				clobj = tmp;
+				io->ci_obj = clobj;
+				io->ci_ignore_layout = 1;
+				rc = cl_io_init(env, io, CIT_MISC, clobj);
 
-			clobj = tmp;
-			io->ci_obj = clobj;
-			io->ci_ignore_layout = 1;
-			rc = cl_io_init(env, io, CIT_MISC, clobj);
+				spin_lock(&part->clp_lock);
 
-			spin_lock(&cli->cl_lru_list_lock);
+				if (rc != 0)
+					break;
 
-			if (rc != 0)
-				break;
+				++maxscan;
+				continue;
+			}
 
-			++maxscan;
-			continue;
-		}
+			if (cl_page_own_try(env, io, page) == 0) {
+				if (!lru_page_busy(cli, page)) {
+					/* remove it from lru list earlier to
+					 * avoid lock contention */
+					__osc_lru_del(cli, opg);
+					/* will be discarded */
+					opg->ops_in_lru = 0;
+
+					cl_page_get(page);
+					will_free = true;
+				} else {
+					cl_page_disown(env, io, page);
+				}
+			}
 
-		if (cl_page_own_try(env, io, page) == 0) {
-			if (!lru_page_busy(cli, page)) {
-				/* remove it from lru list earlier to avoid
-				 * lock contention */
-				__osc_lru_del(cli, opg);
-				opg->ops_in_lru = 0; /* will be discarded */
-
-				cl_page_get(page);
-				will_free = true;
-			} else {
-				cl_page_disown(env, io, page);
+			if (!will_free) {
+				list_move_tail(&opg->ops_lru, &part->clp_list);
+				continue;
 			}
-		}
 
-		if (!will_free) {
-			list_move_tail(&opg->ops_lru, &cli->cl_lru_list);
-			continue;
-		}
+			/* Don't discard and free the page with clp_lock held */
+			pvec[index++] = page;
+			if (unlikely(index == OTI_PVEC_SIZE)) {
+				spin_unlock(&part->clp_lock);
+				discard_pagevec(env, io, pvec, index);
+				index = 0;
 
-		/* Don't discard and free the page with cl_lru_list held */
-		pvec[index++] = page;
-		if (unlikely(index == OTI_PVEC_SIZE)) {
-			spin_unlock(&cli->cl_lru_list_lock);
-			discard_pagevec(env, io, pvec, index);
-			index = 0;
+				spin_lock(&part->clp_lock);
+			}
 
-			spin_lock(&cli->cl_lru_list_lock);
+			if (++count >= target)
+				break;
 		}
+		spin_unlock(&part->clp_lock);
 
-		if (++count >= target)
+		if (!force && atomic_read(&cli->cl_lru_shrinkers) > 1)
 			break;
 	}
-	spin_unlock(&cli->cl_lru_list_lock);
 
 	if (clobj != NULL) {
 		discard_pagevec(env, io, pvec, index);
@@ -61,6 +61,15 @@ module_param(osc_reqpool_mem_max, uint, 0444);
 static int osc_idle_timeout = 20;
 module_param(osc_idle_timeout, uint, 0644);
 
+/* min number of pages in an encrypted BRW for its pages to be encrypted or
+ * decrypted in parallel by crypto workers, 0 to disable
+ */
+static unsigned int osc_crypt_parallel_pages = 64;
+module_param(osc_crypt_parallel_pages, uint, 0644);
+
+/* crypto workers, one workqueue per CPU partition */
+static struct workqueue_struct **osc_crypt_wqs;
+
 #define osc_grant_args osc_brw_async_args
 
 struct osc_setattr_args {
@@ -1298,6 +1307,7 @@ static int osc_checksum_bulk(int nob, size_t pg_count,
 {
 	int				i = 0;
 	struct ahash_request	       *req;
+	struct obd_cksum_pages		ocp;
 	unsigned int			bufsize;
 	unsigned char			cfs_alg = cksum_obd2cfs(cksum_type);
 
@@ -1309,6 +1319,7 @@ static int osc_checksum_bulk(int nob, size_t pg_count,
 		       cfs_crypto_hash_name(cfs_alg));
 		return PTR_ERR(req);
 	}
+	obd_cksum_pages_init(&ocp, req);
 
 	while (nob > 0 && pg_count > 0) {
 		unsigned int count = pga[i]->count > nob ? nob : pga[i]->count;
@@ -1323,9 +1334,8 @@ static int osc_checksum_bulk(int nob, size_t pg_count,
 			memcpy(ptr + off, "bad1", min_t(typeof(nob), 4, nob));
 			kunmap(pga[i]->pg);
 		}
-		cfs_crypto_hash_update_page(req, pga[i]->pg,
-					    pga[i]->off & ~PAGE_MASK,
-					    count);
+		obd_cksum_pages_add(&ocp, pga[i]->pg, pga[i]->off & ~PAGE_MASK,
+				    count);
 		LL_CDEBUG_PAGE(D_PAGE, pga[i]->pg, "off %d\n",
 			       (int)(pga[i]->off & ~PAGE_MASK));
 
@@ -1333,6 +1343,7 @@ static int osc_checksum_bulk(int nob, size_t pg_count,
 		pg_count--;
 		i++;
 	}
+	obd_cksum_pages_flush(&ocp);
 
 	bufsize = sizeof(*cksum);
 	cfs_crypto_hash_final(req, (unsigned char *)cksum, &bufsize);
@@ -1481,6 +1492,9 @@ static inline void osc_release_bounce_pages(struct brw_page **pga,
 		}
 		pga[i]->count -= pga[i]->bp_count_diff;
 		pga[i]->off += pga[i]->bp_off_diff;
+		/* so that releasing again is harmless */
+		pga[i]->bp_count_diff = 0;
+		pga[i]->bp_off_diff = 0;
 	}
 
 	if (pa) {
@@ -1490,6 +1504,343 @@ static inline void osc_release_bounce_pages(struct brw_page **pga,
 #endif
 }
 
+#ifdef CONFIG_LL_ENCRYPTION
+/*
+ * Make @brwpg point to bounce page @dstpage before its clear text page is
+ * encrypted, the same way osc_encrypt_pagecache_blocks() does. Then
+ * osc_release_bounce_pages() restores the clear text page whether encryption
+ * is done, failed or not started.
+ */
+static inline void osc_brw_set_bounce_page(struct brw_page *brwpg,
+					   struct page *dstpage)
+{
+	SetPagePrivate2(dstpage);
+	SetPagePrivate(dstpage);
+	set_page_private(dstpage, (unsigned long)brwpg->pg);
+	SetPageChecked(dstpage);
+	brwpg->pg = dstpage;
+}
+#endif
+
+/*
+ * Encrypt clear text page @srcpage of @brwpg into bounce page @dstpage, or
+ * into a page allocated by llcrypt if @dstpage is NULL, and make @brwpg point
+ * to the cipher text. @brwpg count and offset already cover whole encryption
+ * units.
+ */
+static int osc_brw_encrypt_page(struct inode *inode, struct brw_page *brwpg,
+				struct page *srcpage, struct page *dstpage,
+				bool directio)
+{
+	struct address_space *map_orig = NULL;
+	pgoff_t index_orig = 0;
+	struct page *data_page;
+	bool retried = false;
+	bool lockedbymyself;
+
+retry_encrypt:
+	/* The page can already be locked when we arrive here.
+	 * This is possible when cl_page_assume/vvp_page_assume
+	 * is stuck on wait_on_page_writeback with page lock
+	 * held. In this case there is no risk for the lock to
+	 * be released while we are doing our encryption
+	 * processing, because writeback against that page will
+	 * end in vvp_page_completion_write/cl_page_completion,
+	 * which means only once the page is fully processed.
+	 */
+	lockedbymyself = trylock_page(srcpage);
+	if (directio) {
+		struct cl_page *clpage = oap2cl_page(brw_page2oap(brwpg));
+
+		map_orig = srcpage->mapping;
+		srcpage->mapping = inode->i_mapping;
+		index_orig = srcpage->index;
+		srcpage->index = clpage->cp_page_index;
+	}
+	data_page = osc_encrypt_pagecache_blocks(srcpage, dstpage,
+						 brwpg->count, 0, GFP_NOFS);
+	if (directio) {
+		srcpage->mapping = map_orig;
+		srcpage->index = index_orig;
+	}
+	if (lockedbymyself)
+		unlock_page(srcpage);
+	if (IS_ERR(data_page)) {
+		if (PTR_ERR(data_page) == -ENOMEM && !retried) {
+			retried = true;
+			goto retry_encrypt;
+		}
+		return PTR_ERR(data_page);
+	}
+	/* Set PageChecked flag on bounce page for
+	 * disambiguation in osc_release_bounce_pages().
+	 */
+	SetPageChecked(data_page);
+	brwpg->pg = data_page;
+
+	return 0;
+}
+
+/*
+ * Decrypt in place the cipher text read into @brwpg. @blockbits is only set
+ * for direct IO, whose pages are not in the page cache.
+ */
+static int osc_brw_decrypt_page(struct inode *inode, struct brw_page *brwpg,
+				unsigned int blockbits)
+{
+	unsigned int offs = 0;
+	int rc = 0;
+
+	while (offs < PAGE_SIZE) {
+		/* do not decrypt if page is all 0s */
+		if (memchr_inv(page_address(brwpg->pg) + offs, 0,
+			       LUSTRE_ENCRYPTION_UNIT_SIZE) == NULL) {
+			/* if page is empty forward info to upper layers
+			 * (ll_io_zero_page) by clearing PagePrivate2
+			 */
+			if (!offs)
+				ClearPagePrivate2(brwpg->pg);
+			break;
+		}
+
+		if (blockbits) {
+			/* This is direct IO case. Directly call
+			 * decrypt function that takes inode as
+			 * input parameter. Page does not need
+			 * to be locked.
+			 */
+			struct cl_page *clpage =
+				oap2cl_page(brw_page2oap(brwpg));
+			unsigned int blocksize = 1 << blockbits;
+			u64 lblk_num;
+			unsigned int i;
+
+			lblk_num = ((u64)(clpage->cp_page_index) <<
+				    (PAGE_SHIFT - blockbits)) +
+				   (offs >> blockbits);
+			for (i = offs; i < offs + LUSTRE_ENCRYPTION_UNIT_SIZE;
+			     i += blocksize, lblk_num++) {
+				rc = llcrypt_decrypt_block_inplace(inode,
+								   brwpg->pg,
+								   blocksize, i,
+								   lblk_num);
+				if (rc)
+					break;
+			}
+		} else {
+			rc = llcrypt_decrypt_pagecache_blocks(brwpg->pg,
+						LUSTRE_ENCRYPTION_UNIT_SIZE,
+						offs);
+		}
+		if (rc)
+			return rc;
+
+		offs += LUSTRE_ENCRYPTION_UNIT_SIZE;
+	}
+
+	return 0;
+}
+
+/* number of pages of a BRW a crypto worker processes at once */
+#define OSC_CRYPT_CHUNK_PAGES	16
+
+struct osc_brw_crypt;
+
+struct osc_brw_crypt_work {
+	struct work_struct	 obcw_work;
+	struct osc_brw_crypt	*obcw_crypt;
+};
+
+/*
+ * Encryption or decryption of the pages of one BRW, shared between the
+ * submitting thread and crypto workers. Each of them claims chunks of
+ * OSC_CRYPT_CHUNK_PAGES pages until there is none left.
+ */
+struct osc_brw_crypt {
+	struct inode			 *obc_inode;
+	struct brw_page			**obc_pga;
+	u32				  obc_page_count;
+	u32				  obc_chunks;
+	/* for decryption of direct IO pages */
+	unsigned int			  obc_blockbits;
+	bool				  obc_write;
+	bool				  obc_directio;
+	/* next chunk to claim */
+	atomic_t			  obc_next;
+	/* submitter and crypto workers not done yet */
+	atomic_t			  obc_running;
+	/* first error hit */
+	int				  obc_rc;
+	struct completion		  obc_done;
+	int				  obc_nworks;
+	struct osc_brw_crypt_work	  obc_works[];
+};
+
+static void osc_brw_crypt_chunks(struct osc_brw_crypt *obc)
+{
+	u32 chunk;
+	int rc = 0;
+
+	while (rc == 0 && READ_ONCE(obc->obc_rc) == 0 &&
+	       (chunk = atomic_inc_return(&obc->obc_next) - 1) <
+	       obc->obc_chunks) {
+		u32 i = chunk * OSC_CRYPT_CHUNK_PAGES;
+		u32 end = min(i + OSC_CRYPT_CHUNK_PAGES, obc->obc_page_count);
+
+		for (; i < end && rc == 0; i++) {
+			struct brw_page *brwpg = obc->obc_pga[i];
+
+			/* clear text page was stored in bounce page by
+			 * osc_brw_set_bounce_page()
+			 */
+			if (obc->obc_write)
+				rc = osc_brw_encrypt_page(obc->obc_inode, brwpg,
+					(struct page *)page_private(brwpg->pg),
+					brwpg->pg, obc->obc_directio);
+			else
+				rc = osc_brw_decrypt_page(obc->obc_inode, brwpg,
+							  obc->obc_blockbits);
+		}
+		if (rc)
+			cmpxchg(&obc->obc_rc, 0, rc);
+	}
+}
+
+static void osc_brw_crypt_handler(struct work_struct *work)
+{
+	struct osc_brw_crypt_work *obcw = container_of(work,
+						       struct osc_brw_crypt_work,
+						       obcw_work);
+	struct osc_brw_crypt *obc = obcw->obcw_crypt;
+
+	osc_brw_crypt_chunks(obc);
+	if (atomic_dec_and_test(&obc->obc_running))
+		complete(&obc->obc_done);
+}
+
+/**
+ * Hand the pages of a large encrypted BRW to the crypto workers of the
+ * current CPU partition, so that they are encrypted or decrypted in parallel
+ * while the caller goes on, e.g. with building the RPC. The caller must call
+ * osc_brw_crypt_wait() before it accesses page contents.
+ *
+ * For encryption, bounce pages must be set with osc_brw_set_bounce_page().
+ *
+ * \retval NULL if pages are to be processed by the caller itself
+ */
+static struct osc_brw_crypt *osc_brw_crypt_start(struct inode *inode,
+						 struct brw_page **pga,
+						 u32 page_count, bool write,
+						 bool directio,
+						 unsigned int blockbits)
+{
+	unsigned int min_pages = READ_ONCE(osc_crypt_parallel_pages);
+	struct osc_brw_crypt *obc;
+	int nworks;
+	int cpt;
+	int i;
+
+	/* crypto workers are not allowed to dip into memory reserves */
+	if (!osc_crypt_wqs || min_pages == 0 || page_count < min_pages ||
+	    (current->flags & PF_MEMALLOC))
+		return NULL;
+
+	cpt = cfs_cpt_current(cfs_cpt_tab, 1);
+	nworks = min_t(int, DIV_ROUND_UP(page_count, OSC_CRYPT_CHUNK_PAGES) - 1,
+		       cfs_cpt_weight(cfs_cpt_tab, cpt));
+	if (nworks <= 0)
+		return NULL;
+
+	OBD_ALLOC(obc, offsetof(struct osc_brw_crypt, obc_works[nworks]));
+	if (!obc)
+		return NULL;
+
+	obc->obc_inode = inode;
+	obc->obc_pga = pga;
+	obc->obc_page_count = page_count;
+	obc->obc_chunks = DIV_ROUND_UP(page_count, OSC_CRYPT_CHUNK_PAGES);
+	obc->obc_blockbits = blockbits;
+	obc->obc_write = write;
+	obc->obc_directio = directio;
+	atomic_set(&obc->obc_next, 0);
+	atomic_set(&obc->obc_running, nworks + 1);
+	init_completion(&obc->obc_done);
+	obc->obc_nworks = nworks;
+
+	for (i = 0; i < nworks; i++) {
+		obc->obc_works[i].obcw_crypt = obc;
+		INIT_WORK(&obc->obc_works[i].obcw_work, osc_brw_crypt_handler);
+		queue_work(osc_crypt_wqs[cpt], &obc->obc_works[i].obcw_work);
+	}
+
+	CDEBUG(D_SEC, "%s %u pages of ino %lu with %d crypto workers\n",
+	       write ? "encrypt" : "decrypt", page_count, inode->i_ino,
+	       nworks);
+
+	return obc;
+}
+
+/**
+ * Process the chunks of pages not claimed by crypto workers yet, wait for the
+ * workers to be done, and free \a obc.
+ *
+ * \retval 0 or first error hit while encrypting or decrypting
+ */
+static int osc_brw_crypt_wait(struct osc_brw_crypt *obc)
+{
+	int rc;
+
+	osc_brw_crypt_chunks(obc);
+	if (!atomic_dec_and_test(&obc->obc_running))
+		wait_for_completion(&obc->obc_done);
+
+	rc = obc->obc_rc;
+	OBD_FREE(obc, offsetof(struct osc_brw_crypt,
+			       obc_works[obc->obc_nworks]));
+
+	return rc;
+}
+
+static void osc_crypt_wqs_fini(void)
+{
+	int i;
+
+	if (!osc_crypt_wqs)
+		return;
+
+	for (i = 0; i < cfs_cpt_number(cfs_cpt_tab); i++)
+		if (osc_crypt_wqs[i])
+			destroy_workqueue(osc_crypt_wqs[i]);
+	OBD_FREE_PTR_ARRAY(osc_crypt_wqs, cfs_cpt_number(cfs_cpt_tab));
+	osc_crypt_wqs = NULL;
+}
+
+static int osc_crypt_wqs_init(void)
+{
+	int ncpts = cfs_cpt_number(cfs_cpt_tab);
+	int rc;
+	int i;
+
+	OBD_ALLOC_PTR_ARRAY(osc_crypt_wqs, ncpts);
+	if (!osc_crypt_wqs)
+		return -ENOMEM;
+
+	for (i = 0; i < ncpts; i++) {
+		/* writeback may wait for crypto workers */
+		osc_crypt_wqs[i] = cfs_cpt_bind_workqueue("osc-crypt",
+					cfs_cpt_tab, WQ_MEM_RECLAIM, i,
+					cfs_cpt_weight(cfs_cpt_tab, i));
+		if (IS_ERR(osc_crypt_wqs[i])) {
+			rc = PTR_ERR(osc_crypt_wqs[i]);
+			osc_crypt_wqs[i] = NULL;
+			osc_crypt_wqs_fini();
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
 static int
 osc_brw_prep_request(int cmd, struct client_obd *cli, struct obdo *oa,
 		     u32 page_count, struct brw_page **pga,
@@ -1509,6 +1860,7 @@ osc_brw_prep_request(int cmd, struct client_obd *cli, struct obdo *oa,
 	struct inode *inode = NULL;
 	bool directio = false;
 	bool enable_checksum = true;
+	struct osc_brw_crypt *crypt = NULL;
 	struct cl_page *clpage;
 
 	ENTRY;
@@ -1550,6 +1902,7 @@ osc_brw_prep_request(int cmd, struct client_obd *cli, struct obdo *oa,
 		if (rc) {
 			CDEBUG(D_SEC, "failed to allocate from enc pool: %d\n",
 			       rc);
+			OBD_FREE_PTR_ARRAY_LARGE(pa, page_count);
 			ptlrpc_request_free(req);
 			RETURN(rc);
 		}
@@ -1557,64 +1910,8 @@ osc_brw_prep_request(int cmd, struct client_obd *cli, struct obdo *oa,
 
 		for (i = 0; i < page_count; i++) {
 			struct brw_page *brwpg = pga[i];
-			struct page *data_page = NULL;
-			bool retried = false;
-			bool lockedbymyself;
 			u32 nunits = (brwpg->off & ~PAGE_MASK) + brwpg->count;
-			struct address_space *map_orig = NULL;
-			pgoff_t index_orig;
 
-retry_encrypt:
-			nunits = round_up(nunits, LUSTRE_ENCRYPTION_UNIT_SIZE);
-			/* The page can already be locked when we arrive here.
-			 * This is possible when cl_page_assume/vvp_page_assume
-			 * is stuck on wait_on_page_writeback with page lock
-			 * held. In this case there is no risk for the lock to
-			 * be released while we are doing our encryption
-			 * processing, because writeback against that page will
-			 * end in vvp_page_completion_write/cl_page_completion,
-			 * which means only once the page is fully processed.
-			 */
-			lockedbymyself = trylock_page(brwpg->pg);
-			if (directio) {
-				map_orig = brwpg->pg->mapping;
-				brwpg->pg->mapping = inode->i_mapping;
-				index_orig = brwpg->pg->index;
-				clpage = oap2cl_page(brw_page2oap(brwpg));
-				brwpg->pg->index = clpage->cp_page_index;
-			}
-			data_page =
-				osc_encrypt_pagecache_blocks(brwpg->pg,
-							    pa ? pa[i] : NULL,
-							    nunits, 0,
-							    GFP_NOFS);
-			if (directio) {
-				brwpg->pg->mapping = map_orig;
-				brwpg->pg->index = index_orig;
-			}
-			if (lockedbymyself)
-				unlock_page(brwpg->pg);
-			if (IS_ERR(data_page)) {
-				rc = PTR_ERR(data_page);
-				if (rc == -ENOMEM && !retried) {
-					retried = true;
-					rc = 0;
-					goto retry_encrypt;
-				}
-				if (pa) {
-					sptlrpc_enc_pool_put_pages_array(pa + i,
-								page_count - i);
-					OBD_FREE_PTR_ARRAY_LARGE(pa,
-								 page_count);
-				}
-				ptlrpc_request_free(req);
-				RETURN(rc);
-			}
-			/* Set PageChecked flag on bounce page for
-			 * disambiguation in osc_release_bounce_pages().
-			 */
-			SetPageChecked(data_page);
-			brwpg->pg = data_page;
 			/* there should be no gap in the middle of page array */
 			if (i == page_count - 1) {
 				struct osc_async_page *oap =
@@ -1626,14 +1923,46 @@ retry_encrypt:
 			/* len is forced to nunits, and relative offset to 0
 			 * so store the old, clear text info
 			 */
+			nunits = round_up(nunits, LUSTRE_ENCRYPTION_UNIT_SIZE);
 			brwpg->bp_count_diff = nunits - brwpg->count;
 			brwpg->count = nunits;
 			brwpg->bp_off_diff = brwpg->off & ~PAGE_MASK;
 			brwpg->off = brwpg->off & PAGE_MASK;
+#ifdef CONFIG_LL_ENCRYPTION
+			osc_brw_set_bounce_page(brwpg, pa[i]);
+#endif
+		}
+
+		/* Large BRWs are encrypted by crypto workers while the RPC is
+		 * being built. Bounce pages are already known, only their
+		 * content is needed before the RPC is sent.
+		 */
+		if (pa)
+			crypt = osc_brw_crypt_start(inode, pga, page_count,
+						    true, directio, 0);
+		for (i = 0, rc = 0; !crypt && i < page_count; i++) {
+			struct page *srcpage = pga[i]->pg;
+
+			/* clear text page was stored in bounce page by
+			 * osc_brw_set_bounce_page()
+			 */
+			if (pa)
+				srcpage = (struct page *)page_private(pa[i]);
+			rc = osc_brw_encrypt_page(inode, pga[i], srcpage,
+						  pa ? pa[i] : NULL, directio);
+			if (rc)
+				break;
 		}
 
 		if (pa)
 			OBD_FREE_PTR_ARRAY_LARGE(pa, page_count);
+		/* pages already encrypted or bound to a bounce page are
+		 * released by the caller with osc_release_bounce_pages()
+		 */
+		if (rc) {
+			ptlrpc_request_free(req);
+			RETURN(rc);
+		}
 	} else if (opc == OST_WRITE && inode && IS_ENCRYPTED(inode)) {
 		struct osc_async_page *oap = brw_page2oap(pga[0]);
 		struct cl_page *clpage = oap2cl_page(oap);
@@ -1722,6 +2051,8 @@ retry_encrypt:
 
         rc = ptlrpc_request_pack(req, LUSTRE_OST_VERSION, opc);
         if (rc) {
+		if (crypt)
+			osc_brw_crypt_wait(crypt);
                 ptlrpc_request_free(req);
                 RETURN(rc);
         }
@@ -1802,6 +2133,14 @@ no_bulk:
 		}
 	}
 
+	/* cipher text is needed from now on */
+	if (crypt) {
+		rc = osc_brw_crypt_wait(crypt);
+		crypt = NULL;
+		if (rc)
+			GOTO(out, rc);
+	}
+
 	LASSERT(page_count > 0);
 	pg_prev = pga[0];
         for (requested_nob = i = 0; i < page_count; i++, niobuf++) {
@@ -1945,6 +2284,8 @@ no_bulk:
         RETURN(0);
 
  out:
+	if (crypt)
+		osc_brw_crypt_wait(crypt);
         ptlrpc_req_finished(req);
         RETURN(rc);
 }
@@ -2109,7 +2450,7 @@ static int osc_brw_fini_request(struct ptlrpc_request *req, int rc)
 	struct ost_body *body;
 	u32 client_cksum = 0;
 	struct inode *inode = NULL;
-	unsigned int blockbits = 0, blocksize = 0;
+	unsigned int blockbits = 0;
 	struct cl_page *clpage;
 
 	ENTRY;
@@ -2307,72 +2648,28 @@ static int osc_brw_fini_request(struct ptlrpc_request *req, int rc)
 	/* get the inode from the first cl_page */
 	clpage = oap2cl_page(brw_page2oap(aa->aa_ppga[0]));
 	inode = clpage->cp_inode;
-	if (clpage->cp_type == CPT_TRANSIENT && inode) {
+	if (clpage->cp_type == CPT_TRANSIENT && inode)
 		blockbits = inode->i_blkbits;
-		blocksize = 1 << blockbits;
-	}
 	if (inode && IS_ENCRYPTED(inode)) {
+		struct osc_brw_crypt *crypt;
 		int idx;
 
 		if (!llcrypt_has_encryption_key(inode)) {
 			CDEBUG(D_SEC, "no enc key for ino %lu\n", inode->i_ino);
 			GOTO(out, rc);
 		}
-		for (idx = 0; idx < aa->aa_page_count; idx++) {
-			struct brw_page *brwpg = aa->aa_ppga[idx];
-			unsigned int offs = 0;
-
-			while (offs < PAGE_SIZE) {
-				/* do not decrypt if page is all 0s */
-				if (memchr_inv(page_address(brwpg->pg) + offs,
-				      0, LUSTRE_ENCRYPTION_UNIT_SIZE) == NULL) {
-					/* if page is empty forward info to
-					 * upper layers (ll_io_zero_page) by
-					 * clearing PagePrivate2
-					 */
-					if (!offs)
-						ClearPagePrivate2(brwpg->pg);
-					break;
-				}
-
-				if (blockbits) {
-					/* This is direct IO case. Directly call
-					 * decrypt function that takes inode as
-					 * input parameter. Page does not need
-					 * to be locked.
-					 */
-					u64 lblk_num;
-					unsigned int i;
-
-					clpage =
-					       oap2cl_page(brw_page2oap(brwpg));
-					lblk_num =
-						((u64)(clpage->cp_page_index) <<
-						(PAGE_SHIFT - blockbits)) +
-						(offs >> blockbits);
-					for (i = offs;
-					     i < offs +
-						    LUSTRE_ENCRYPTION_UNIT_SIZE;
-					     i += blocksize, lblk_num++) {
-						rc =
-						  llcrypt_decrypt_block_inplace(
-							  inode, brwpg->pg,
-							  blocksize, i,
-							  lblk_num);
-						if (rc)
-							break;
-					}
-				} else {
-					rc = llcrypt_decrypt_pagecache_blocks(
-						brwpg->pg,
-						LUSTRE_ENCRYPTION_UNIT_SIZE,
-						offs);
-				}
-				if (rc)
-					GOTO(out, rc);
 
-				offs += LUSTRE_ENCRYPTION_UNIT_SIZE;
-			}
+		crypt = osc_brw_crypt_start(inode, aa->aa_ppga,
+					    aa->aa_page_count, false,
+					    blockbits != 0, blockbits);
+		if (crypt)
+			GOTO(out, rc = osc_brw_crypt_wait(crypt));
+
+		for (idx = 0; idx < aa->aa_page_count; idx++) {
+			rc = osc_brw_decrypt_page(inode, aa->aa_ppga[idx],
+						  blockbits);
+			if (rc)
+				GOTO(out, rc);
 		}
 	}
 
@@ -2400,8 +2697,11 @@ static int osc_brw_redo_request(struct ptlrpc_request *request,
 				OST_WRITE ? OBD_BRW_WRITE : OBD_BRW_READ,
 				  aa->aa_cli, aa->aa_oa, aa->aa_page_count,
 				  aa->aa_ppga, &new_req, 1);
-        if (rc)
-                RETURN(rc);
+	if (rc) {
+		/* pages may have been bound to bounce pages already */
+		osc_release_bounce_pages(aa->aa_ppga, aa->aa_page_count);
+		RETURN(rc);
+	}
 
 	list_for_each_entry(oap, &aa->aa_oaps, oap_rpc_item) {
 		if (oap->oap_request != NULL) {
@@ -2489,6 +2789,76 @@ static void osc_release_ppga(struct brw_page **ppga, size_t count)
 	OBD_FREE_PTR_ARRAY_LARGE(ppga, count);
 }
 
+/* refresh the baseline RPC time this often, the OST load may go down */
+#define OSC_RIF_RTT_MIN_AGE	30
+
+/**
+ * Adjust the limit of RPCs in flight by the reply of a BRW RPC, in the
+ * way of TCP congestion control: the limit grows by one after a window of
+ * replies while it is used up, and shrinks when the OST is overloaded.
+ * Overload is signalled by early replies, which the OST sends when it
+ * can't serve the RPC in time, and by service time growing well above the
+ * baseline, which means RPCs wait in the OST queue.
+ *
+ * Called with cl_loi_list_lock held.
+ */
+static void osc_rif_update(struct client_obd *cli, struct ptlrpc_request *req,
+			   u32 page_count)
+{
+	u32 limit = osc_rif_limit(cli);
+	time64_t now = ktime_get_seconds();
+	u64 rtt;
+
+	if (!cli->cl_rif_auto)
+		return;
+
+	if (req->rq_early_count > 0) {
+		cli->cl_rif_limit = max_t(u32, limit / 2, cli->cl_rif_min);
+		goto decreased;
+	}
+
+	/* service time is only comparable between full RPCs */
+	if (page_count == cli->cl_max_pages_per_rpc &&
+	    ktime_to_ns(req->rq_sent_ns) != 0) {
+		rtt = ktime_us_delta(ktime_get(), req->rq_sent_ns);
+		if (cli->cl_rif_rtt_min == 0 || rtt < cli->cl_rif_rtt_min ||
+		    now > cli->cl_rif_rtt_min_time + OSC_RIF_RTT_MIN_AGE) {
+			cli->cl_rif_rtt_min = rtt;
+			cli->cl_rif_rtt_min_time = now;
+		}
+		cli->cl_rif_rtt_avg = cli->cl_rif_rtt_avg == 0 ? rtt :
+				      (cli->cl_rif_rtt_avg * 7 + rtt) / 8;
+
+		if (cli->cl_rif_rtt_avg > 2 * cli->cl_rif_rtt_min &&
+		    limit > cli->cl_rif_min) {
+			cli->cl_rif_limit = limit - 1;
+			goto decreased;
+		}
+	}
+
+	cli->cl_rif_limit = limit;
+	if (++cli->cl_rif_acked < limit)
+		return;
+
+	cli->cl_rif_acked = 0;
+	/* don't grow the window unless it was used up */
+	if (limit < cli->cl_max_rpcs_in_flight &&
+	    rpcs_in_flight(cli) >= limit) {
+		cli->cl_rif_limit = limit + 1;
+		cli->cl_rif_increases++;
+		CDEBUG(D_CACHE, "%s: RPCs in flight limit up to %u\n",
+		       cli_name(cli), cli->cl_rif_limit);
+	}
+	return;
+
+decreased:
+	cli->cl_rif_acked = 0;
+	cli->cl_rif_decreases++;
+	CDEBUG(D_CACHE, "%s: RPCs in flight limit down to %u, early %d, rtt %llu/%llu usec\n",
+	       cli_name(cli), cli->cl_rif_limit, req->rq_early_count,
+	       cli->cl_rif_rtt_avg, cli->cl_rif_rtt_min);
+}
+
 static int brw_interpret(const struct lu_env *env,
 			 struct ptlrpc_request *req, void *args, int rc)
 {
@@ -2606,6 +2976,8 @@ static int brw_interpret(const struct lu_env *env,
 	ptlrpc_lprocfs_brw(req, transferred);
 
 	spin_lock(&cli->cl_loi_list_lock);
+	if (rc == 0)
+		osc_rif_update(cli, req, aa->aa_page_count);
 	/* We need to decrement before osc_ap_completion->osc_wake_cache_waiters
 	 * is called so we know whether to go to sync BRWs or wait for more
 	 * RPCs to complete */
@@ -3910,8 +4282,14 @@ static int __init osc_init(void)
 	if (rc != 0)
 		GOTO(out_req_pool, rc);
 
+	rc = osc_crypt_wqs_init();
+	if (rc != 0)
+		GOTO(out_grant_work, rc);
+
 	RETURN(rc);
 
+out_grant_work:
+	osc_stop_grant_work();
 out_req_pool:
 	ptlrpc_free_rq_pool(osc_rq_pool);
 out_shrinker:
@@ -3926,6 +4304,7 @@ out_kmem:
 
 static void __exit osc_exit(void)
 {
+	osc_crypt_wqs_fini();
 	osc_stop_grant_work();
 	unregister_shrinker(&osc_cache_shrinker);
 	class_unregister_type(LUSTRE_OSC_NAME);
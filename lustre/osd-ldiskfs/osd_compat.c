@@ -349,6 +349,7 @@ int osd_add_to_remote_parent(const struct lu_env *env, struct osd_device *osd,
 			     sizeof(*lma), XATTR_REPLACE);
 	if (rc)
 		RETURN(rc);
+	osd_xattr_version_bump(obj);
 
 	parent = omm->omm_remote_parent;
 	sprintf(name, DFID_NOBRACE, PFID(lu_object_fid(&obj->oo_dt.do_lu)));
@@ -426,8 +427,10 @@ int osd_delete_from_remote_parent(const struct lu_env *env,
 	lustre_lma_swab(lma);
 	rc = __osd_xattr_set(oti, obj->oo_inode, XATTR_NAME_LMA, lma,
 			     sizeof(*lma), XATTR_REPLACE);
-	if (!rc)
+	if (!rc) {
+		osd_xattr_version_bump(obj);
 		lu_object_clear_agent_entry(&obj->oo_dt.do_lu);
+	}
 	RETURN(rc);
 }
 
@@ -1496,6 +1496,7 @@ static int osd_object_init(const struct lu_env *env, struct lu_object *l,
 
 	result = osd_fid_lookup(env, obj, lu_object_fid(l), conf);
 	obj->oo_dt.do_body_ops = &osd_body_ops_new;
+	osd_xattr_version_bump(obj);
 	if (result == 0 && obj->oo_inode != NULL) {
 		struct osd_thread_info *oti = osd_oti_get(env);
 		struct lustre_ost_attrs *loa = &oti->oti_ost_attrs;
@@ -3273,13 +3274,15 @@ static int osd_attr_set(const struct lu_env *env,
 
 		rc = __osd_xattr_set(info, inode, XATTR_NAME_LMA,
 				     lma, sizeof(*lma), XATTR_REPLACE);
-		if (rc != 0)
+		if (rc != 0) {
 			CWARN("%s: set "DFID" lma flags %u failed: rc = %d\n",
 			      osd_name(osd), PFID(lu_object_fid(&dt->do_lu)),
 			      lma->lma_incompat, rc);
-		else
+		} else {
 			obj->oo_lma_flags =
 				attr->la_flags & LUSTRE_LMA_FL_MASKS;
+			osd_xattr_version_bump(obj);
+		}
 		osd_trans_exec_check(env, handle, OSD_OT_XATTR_SET);
 	}
 
@@ -4498,6 +4501,19 @@ static int osd_xattr_get(const struct lu_env *env, struct dt_object *dt,
 		return sizeof(dt_obj_version_t);
 	}
 
+	/* nor is the version of the xattr set, it is kept in memory */
+	if (strcmp(name, XATTR_NAME_XATTR_VERSION) == 0) {
+		if (buf->lb_len == 0)
+			return sizeof(obj->oo_xattr_version);
+
+		if (buf->lb_len < sizeof(obj->oo_xattr_version))
+			return -ERANGE;
+
+		*(__u64 *)buf->lb_buf = READ_ONCE(obj->oo_xattr_version);
+
+		return sizeof(obj->oo_xattr_version);
+	}
+
 	if (!dt_object_exists(dt))
 		return -ENOENT;
 
@@ -4902,6 +4918,8 @@ static int osd_xattr_set(const struct lu_env *env, struct dt_object *dt,
 		LASSERT(buf->lb_buf);
 
 		fl = osd_xattr_set_pfid(env, obj, buf, fl, handle);
+		if (fl == 0)
+			osd_xattr_version_bump(obj);
 		if (fl <= 0)
 			RETURN(fl);
 	} else if (strcmp(name, XATTR_NAME_LMV) == 0) {
@@ -4955,6 +4973,9 @@ static int osd_xattr_set(const struct lu_env *env, struct dt_object *dt,
 	}
 	osd_trans_exec_check(env, handle, OSD_OT_XATTR_SET);
 
+	if (rc == 0)
+		osd_xattr_version_bump(obj);
+
 	if (rc == 0 &&
 	    (strcmp(name, XATTR_NAME_LOV) == 0 ||
 	     strcmp(name, XATTR_NAME_DEFAULT_LMV) == 0))
@@ -5084,6 +5105,9 @@ static int osd_xattr_del(const struct lu_env *env, struct dt_object *dt,
 
 	osd_trans_exec_check(env, handle, OSD_OT_XATTR_SET);
 
+	if (rc == 0)
+		osd_xattr_version_bump(obj);
+
 	if (rc == 0 &&
 	    (strcmp(name, XATTR_NAME_LOV) == 0 ||
 	     strcmp(name, XATTR_NAME_DEFAULT_LMV) == 0))
@@ -8241,6 +8265,7 @@ static int osd_device_init0(const struct lu_env *env,
 	o->od_index_backup_policy = LIBP_NONE;
 	o->od_t10_type = 0;
 	init_waitqueue_head(&o->od_commit_cb_done);
+	atomic64_set(&o->od_xattr_version, 0);
 
 	o->od_read_cache = 1;
 	o->od_writethrough_cache = 1;
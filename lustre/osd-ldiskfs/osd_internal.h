@@ -163,6 +163,8 @@ struct osd_object {
 	struct list_head	oo_xattr_list;
 	struct lu_object_header *oo_header;
 	__u64			oo_dirent_count;
+	/* version of the xattr set, see osd_xattr_version_bump() */
+	__u64			oo_xattr_version;
 };
 
 struct osd_obj_seq {
@@ -363,6 +365,8 @@ struct osd_device {
 	atomic_t		 od_commit_cb_in_flight;
 	wait_queue_head_t	 od_commit_cb_done;
 	unsigned int __percpu	*od_extent_bytes_percpu;
+	/* last xattr version given to an object since mount */
+	atomic64_t		 od_xattr_version;
 };
 
 static inline struct qsd_instance *osd_def_qsd(struct osd_device *osd)
@@ -1109,6 +1113,20 @@ static inline struct osd_device *osd_obj2dev(const struct osd_object *o)
         return osd_dev(o->oo_dt.do_lu.lo_dev);
 }
 
+/*
+ * Give \a obj a new xattr version, on load and on every xattr update. The
+ * versions come from one counter of the device, so none is handed out twice
+ * during a mount, not even to the same object after it was dropped from the
+ * cache. The counter starts from 0 at every mount, the MDT adds the mount
+ * count of the target to tell versions of different mounts apart, see
+ * mdt_xattr_version().
+ */
+static inline void osd_xattr_version_bump(struct osd_object *obj)
+{
+	WRITE_ONCE(obj->oo_xattr_version,
+		   atomic64_inc_return(&osd_obj2dev(obj)->od_xattr_version));
+}
+
 static inline struct super_block *osd_sb(const struct osd_device *dev)
 {
 	return dev->od_mnt->mnt_sb;
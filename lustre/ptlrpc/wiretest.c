@@ -1666,6 +1666,8 @@ void lustre_assert_wire_constants(void)
 		 OBD_MD_FLLAZYBLOCKS);
 	LASSERTF(OBD_MD_ENCCTX == (0x2000000000000000ULL), "found 0x%.16llxULL\n",
 		 OBD_MD_ENCCTX);
+	LASSERTF(OBD_MD_FLXATTRVER == (0x8000000000000000ULL), "found 0x%.16llxULL\n",
+		 OBD_MD_FLXATTRVER);
 	BUILD_BUG_ON(OBD_FL_INLINEDATA != 0x00000001);
 	BUILD_BUG_ON(OBD_FL_OBDMDEXISTS != 0x00000002);
 	BUILD_BUG_ON(OBD_FL_DELORPHAN != 0x00000004);
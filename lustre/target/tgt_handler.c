@@ -1796,6 +1796,7 @@ static int tgt_checksum_niobuf(struct lu_target *tgt,
 				 __u32 *cksum)
 {
 	struct ahash_request	       *req;
+	struct obd_cksum_pages		ocp;
 	unsigned int			bufsize;
 	int				i, err;
 	unsigned char			cfs_alg = cksum_obd2cfs(cksum_type);
@@ -1806,6 +1807,7 @@ static int tgt_checksum_niobuf(struct lu_target *tgt,
 		       tgt_name(tgt), cfs_crypto_hash_name(cfs_alg));
 		return PTR_ERR(req);
 	}
+	obd_cksum_pages_init(&ocp, req);
 
 	CDEBUG(D_INFO, "Checksum for algo %s\n", cfs_crypto_hash_name(cfs_alg));
 	for (i = 0; i < npages; i++) {
@@ -1829,6 +1831,7 @@ static int tgt_checksum_niobuf(struct lu_target *tgt,
 				 * display in dump_all_bulk_pages() */
 				np->index = i;
 
+				obd_cksum_pages_flush(&ocp);
 				cfs_crypto_hash_update_page(req, np, off,
 							    len);
 				continue;
@@ -1837,9 +1840,9 @@ static int tgt_checksum_niobuf(struct lu_target *tgt,
 				       tgt_name(tgt));
 			}
 		}
-		cfs_crypto_hash_update_page(req, local_nb[i].lnb_page,
-				  local_nb[i].lnb_page_offset & ~PAGE_MASK,
-				  local_nb[i].lnb_len);
+		obd_cksum_pages_add(&ocp, local_nb[i].lnb_page,
+				    local_nb[i].lnb_page_offset & ~PAGE_MASK,
+				    local_nb[i].lnb_len);
 
 		 /* corrupt the data after we compute the checksum, to
 		 * simulate an OST->client data error */
@@ -1861,6 +1864,7 @@ static int tgt_checksum_niobuf(struct lu_target *tgt,
 				 * display in dump_all_bulk_pages() */
 				np->index = i;
 
+				obd_cksum_pages_flush(&ocp);
 				cfs_crypto_hash_update_page(req, np, off,
 							    len);
 				continue;
@@ -1870,6 +1874,7 @@ static int tgt_checksum_niobuf(struct lu_target *tgt,
 			}
 		}
 	}
+	obd_cksum_pages_flush(&ocp);
 
 	bufsize = sizeof(*cksum);
 	err = cfs_crypto_hash_final(req, (unsigned char *)cksum, &bufsize);
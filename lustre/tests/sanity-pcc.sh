@@ -1491,6 +1491,85 @@ test_20() {
 }
 run_test 20 "Auto attach works after the inode was once evicted from cache"
 
+ro_pcc_stat() {
+	local name=$1
+
+	do_facet $SINGLEAGT $LCTL get_param -n llite.*.pcc |
+		awk '/'$name':/ { sum += $2 } END { print sum }'
+}
+
+wait_ro_pcc_fetches() {
+	local expected=$1
+	local i
+
+	for ((i = 0; i < 30; i++)); do
+		(( $(ro_pcc_stat ro_fetches) >= expected )) && return 0
+		sleep 1
+	done
+	return 1
+}
+
+test_21() {
+	local loopfile="$TMP/$tfile"
+	local mntpt="/mnt/pcc.$tdir"
+	local hsm_root="$mntpt/$tdir"
+	local file=$DIR/$tdir/$tfile.dat
+	local file2=$DIR/$tdir/$tfile.2.dat
+	local lpcc_path
+	local saved
+
+	setup_loopdev $SINGLEAGT $loopfile $mntpt 50
+	do_facet $SINGLEAGT mkdir -p $hsm_root ||
+		error "mkdir $hsm_root failed"
+	setup_pcc_mapping $SINGLEAGT \
+		"fname={*.dat}\ roid=$HSM_ARCHIVE_NUMBER\ ropcc=1\ ro_capacity_mb=6"
+	do_facet $SINGLEAGT $LCTL get_param llite.*.pcc
+
+	mkdir -p $DIR/$tdir || error "mkdir $DIR/$tdir failed"
+	do_facet $SINGLEAGT dd if=/dev/urandom of=$file bs=1M count=4 ||
+		error "dd write $file failed"
+	lpcc_path=$(lpcc_fid2path $hsm_root $file)
+
+	echo "first read-only open fetches the file into RO-PCC"
+	do_facet $SINGLEAGT cat $file > /dev/null || error "cat $file failed"
+	wait_ro_pcc_fetches 1 ||
+		error "$file was not fetched into RO-PCC"
+	# the fetch reads the file through its own open, not a miss
+	(( $(ro_pcc_stat ro_misses) == 1 )) ||
+		error "$(ro_pcc_stat ro_misses) RO-PCC misses, expect 1"
+	do_facet $SINGLEAGT cmp $file $lpcc_path ||
+		error "RO-PCC copy $lpcc_path differs from $file"
+	check_lpcc_state $file "readonly"
+
+	do_facet $SINGLEAGT cat $file > /dev/null || error "cat $file failed"
+	saved=$(ro_pcc_stat ro_bytes_saved)
+	(( saved >= 4 * 1048576 )) || error "only $saved bytes read from RO-PCC"
+	(( $(ro_pcc_stat ro_hits) > 0 )) || error "no RO-PCC hits"
+
+	echo "modified file is not read from the stale copy"
+	do_facet $SINGLEAGT "echo -n QQQQQ >> $file" ||
+		error "append to $file failed"
+	check_lpcc_state $file "none"
+	wait_ro_pcc_fetches 2 ||
+		error "$file was not fetched again into RO-PCC"
+	check_lpcc_state $file "readonly"
+	do_facet $SINGLEAGT cmp $file $lpcc_path ||
+		error "RO-PCC copy $lpcc_path differs from $file"
+
+	echo "least recently used copy is removed beyond the capacity"
+	do_facet $SINGLEAGT dd if=/dev/urandom of=$file2 bs=1M count=4 ||
+		error "dd write $file2 failed"
+	do_facet $SINGLEAGT cat $file2 > /dev/null || error "cat $file2 failed"
+	wait_ro_pcc_fetches 3 ||
+		error "$file2 was not fetched into RO-PCC"
+	do_facet $SINGLEAGT test -f $lpcc_path &&
+		error "RO-PCC copy of $file should be evicted"
+	(( $(ro_pcc_stat ro_evictions) > 0 )) || error "no RO-PCC eviction"
+	check_lpcc_state $file2 "readonly"
+	do_facet $SINGLEAGT $LCTL get_param llite.*.pcc
+}
+run_test 21 "RO-PCC fetch on read-only open, revalidation and LRU eviction"
+
 #test 101: containers and PCC
 #LU-15170: Test mount namespaces with PCC
 #This tests the cases where the PCC mount is not present in the container by
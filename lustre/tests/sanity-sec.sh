@@ -5120,6 +5120,54 @@ test_62() {
 }
 run_test 62 "e2fsck with encrypted files"
 
+test_63() {
+	local param=/sys/module/osc/parameters/osc_crypt_parallel_pages
+	local testfile=$DIR/$tdir/$tfile
+	local reffile=$TMP/$tfile.ref
+	local wpages
+	local rpages
+
+	$LCTL get_param mdc.*.import | grep -q client_encryption ||
+		skip "client encryption not supported"
+
+	mount.lustre --help |& grep -q "test_dummy_encryption:" ||
+		skip "need dummy encryption support"
+
+	[[ -f $param ]] || skip "need parallel BRW encryption support"
+	stack_trap "echo $(cat $param) > $param" EXIT
+
+	stack_trap "cleanup_for_enc_tests $reffile" EXIT
+	setup_for_enc_tests
+
+	dd if=/dev/urandom of=$reffile bs=1M count=16 ||
+		error "dd $reffile failed"
+
+	# 0 encrypts and decrypts serially, 16 spreads BRWs over workers
+	for wpages in 0 16; do
+		echo $wpages > $param
+		cp $reffile $testfile || error "cp with $wpages pages failed"
+		cancel_lru_locks osc
+		for rpages in 0 16; do
+			echo $rpages > $param
+			cmp $reffile $testfile ||
+				error "read $rpages after write $wpages differs"
+			cancel_lru_locks osc
+		done
+		rm -f $testfile
+	done
+
+	# direct IO pages are not in the page cache
+	echo 16 > $param
+	dd if=$reffile of=$testfile bs=4M oflag=direct ||
+		error "dd direct write failed"
+	cancel_lru_locks osc
+	dd if=$testfile of=$reffile.dio bs=4M iflag=direct ||
+		error "dd direct read failed"
+	stack_trap "rm -f $reffile.dio" EXIT
+	cmp $reffile $reffile.dio || error "direct IO data differs"
+}
+run_test 63 "parallel encryption and decryption of BRW pages"
+
 log "cleanup: ======================================================"
 
 sec_unsetup() {
@@ -10191,6 +10191,76 @@ test_77o() {
 }
 run_test 77o "Verify checksum_type for server (mdt and ofd(obdfilter))"
 
+cleanup_77p() {
+	set_checksums 0
+	set_checksum_type $ORIG_CSUM_TYPE
+	$LCTL set_param osc.*osc-[^mM]*.checksum_dump=0
+	$LCTL set_param fail_loc=0
+	do_facet ost1 $LCTL set_param fail_loc=0
+}
+
+test_77p() {
+	[ $PARALLEL == "yes" ] && skip "skip parallel run"
+	$GSS && skip_env "could not run with gss"
+	remote_ost_nodsh && skip "remote OST with nodsh"
+
+	local file=$DIR/$tfile
+	local osc_file_prefix
+	local dumps
+	local fid
+	local algo
+
+	[ ! -f $F77_TMP ] && setup_f77
+	stack_trap "rm -f $file"
+	$LFS setstripe -c 1 -i 0 $file || error "setstripe failed"
+	fid=$($LFS path2fid $file)
+	osc_file_prefix=$($LCTL get_param -n debug_path)
+	osc_file_prefix=${osc_file_prefix}-checksum_dump-osc-\\${fid}
+
+	stack_trap cleanup_77p
+	set_checksums 1
+	# a dump file is written for every mismatch seen by the client
+	$LCTL set_param osc.*osc-[^mM]*.checksum_dump=1
+
+	for algo in $CKSUM_TYPES; do
+		set_checksum_type $algo
+		cancel_lru_locks osc
+
+		# full RPCs hash many batches of pages, the unaligned
+		# rewrite adds partial page fragments to the batches
+		dd if=$F77_TMP of=$file bs=1M count=$F77SZ ||
+			error "$algo: write error: $?"
+		dd if=$F77_TMP of=$file bs=3000 count=1000 seek=1 skip=1 \
+			conv=notrunc || error "$algo: unaligned write error: $?"
+		cancel_lru_locks osc
+		cmp $F77_TMP $file || error "$algo: file compare failed"
+		dumps=$(ls ${osc_file_prefix}* 2>/dev/null | wc -l)
+		(( dumps == 0 )) ||
+			error "$algo: $dumps checksum mismatches without error"
+
+		#define OBD_FAIL_OST_CHECKSUM_RECEIVE       0x21a
+		do_facet ost1 $LCTL set_param fail_loc=0x8000021a
+		dd if=$F77_TMP of=$file bs=1M count=$F77SZ ||
+			error "$algo: write error: $?"
+		do_facet ost1 $LCTL set_param fail_loc=0
+		dumps=$(ls ${osc_file_prefix}* 2>/dev/null | wc -l)
+		(( dumps > 0 )) ||
+			error "$algo: corrupted write not detected"
+		rm -f ${osc_file_prefix}*
+
+		cancel_lru_locks osc
+		#define OBD_FAIL_OSC_CHECKSUM_RECEIVE       0x408
+		$LCTL set_param fail_loc=0x80000408
+		cmp $F77_TMP $file || error "$algo: file compare failed"
+		$LCTL set_param fail_loc=0
+		dumps=$(ls ${osc_file_prefix}* 2>/dev/null | wc -l)
+		(( dumps > 0 )) ||
+			error "$algo: corrupted read not detected"
+		rm -f ${osc_file_prefix}*
+	done
+}
+run_test 77p "batched bulk checksums match and still catch corruption"
+
 cleanup_test_78() {
 	trap 0
 	rm -f $DIR/$tfile
@@ -10861,6 +10931,184 @@ test_101j() {
 }
 run_test 101j "A complete read block should be submitted when no RA"
 
+test_101k() {
+	$LCTL get_param -n llite.*.read_ahead_feedback_ms &> /dev/null ||
+		skip "no read_ahead_feedback_ms support"
+
+	$LFS setstripe -i 0 -c 1 $DIR/$tfile ||
+		error "setstripe $DIR/$tfile failed"
+	stack_trap "rm -f $DIR/$tfile"
+	dd if=/dev/zero of=$DIR/$tfile bs=1M count=128 ||
+		error "dd 128M file failed"
+
+	local old_fb=$($LCTL get_param -n llite.*.read_ahead_feedback_ms |
+		       head -n 1)
+	stack_trap "$LCTL set_param -n llite.*.read_ahead_feedback_ms=$old_fb"
+	$LCTL set_param -n llite.*.read_ahead_feedback_ms=60001 &&
+		error "read_ahead_feedback_ms above 60000 should fail"
+	$LCTL set_param -n llite.*.read_ahead_feedback_ms=200 ||
+		error "set read_ahead_feedback_ms failed"
+
+	# keep the random reads below on a single readahead stream
+	if $LCTL get_param -n llite.*.read_ahead_streams &> /dev/null; then
+		local old_streams=$($LCTL get_param -n \
+				    llite.*.read_ahead_streams | head -n 1)
+
+		stack_trap "$LCTL set_param -n llite.*.read_ahead_streams=$old_streams"
+		$LCTL set_param -n llite.*.read_ahead_streams=1
+	fi
+
+	cancel_lru_locks osc
+	$LCTL set_param -n llite.*.read_ahead_stats=0
+	dd if=$DIR/$tfile of=/dev/null bs=64k ||
+		error "read $DIR/$tfile failed"
+	$LCTL get_param -n llite.*.read_ahead_stats
+
+	local hits=$($LCTL get_param -n llite.*.read_ahead_stats |
+		     get_named_value 'hits' | calc_total)
+	local misses=$($LCTL get_param -n llite.*.read_ahead_stats |
+		       get_named_value 'misses' | calc_total)
+	local ramp_up=$($LCTL get_param -n llite.*.read_ahead_stats |
+			get_named_value 'feedback_ramp_up' | calc_total)
+	local throttle
+	local cmd="o"
+	local i
+
+	# readahead must still serve a sequential read with feedback enabled
+	(( hits > misses * 10 )) ||
+		error "too few readahead hits $hits, misses $misses"
+	# and grow the window faster than by one RPC
+	(( ramp_up > 0 )) || error "sequential read did not ramp up the window"
+
+	# short sequential runs at random offsets leave what was read ahead
+	# behind, the window must be throttled
+	for ((i = 0; i < 64; i++)); do
+		cmd+="z$(((RANDOM % 124) * 1048576))"
+		cmd+="r262144r262144r262144r262144"
+	done
+	cmd+="c"
+
+	cancel_lru_locks osc
+	$LCTL set_param -n llite.*.read_ahead_stats=0
+	$MULTIOP $DIR/$tfile $cmd || error "random read $DIR/$tfile failed"
+	$LCTL get_param -n llite.*.read_ahead_stats
+
+	throttle=$($LCTL get_param -n llite.*.read_ahead_stats |
+		   get_named_value 'feedback_throttle' | calc_total)
+	(( throttle > 0 )) || error "random read did not throttle the window"
+}
+run_test 101k "readahead window sized from throughput feedback"
+
+test_101l() {
+	$LCTL get_param -n llite.*.read_ahead_streams &> /dev/null ||
+		skip "no read_ahead_streams support"
+
+	$LFS setstripe -i 0 -c 1 $DIR/$tfile ||
+		error "setstripe $DIR/$tfile failed"
+	dd if=/dev/zero of=$DIR/$tfile bs=1M count=128 ||
+		error "dd 128M file failed"
+
+	local old_streams=$($LCTL get_param -n llite.*.read_ahead_streams |
+			    head -n 1)
+	stack_trap "$LCTL set_param -n llite.*.read_ahead_streams=$old_streams"
+
+	local streams
+	local -a misses
+	local cmd="o"
+
+	# two sequential readers interleaved on one file descriptor, at 0M
+	# and 64M, each read at an absolute offset
+	for ((i = 0; i < 32; i++)); do
+		cmd+="z$((i * 1048576))r1048576"
+		cmd+="z$(((i + 64) * 1048576))r1048576"
+	done
+	cmd+="c"
+
+	for streams in 1 4; do
+		$LCTL set_param -n llite.*.read_ahead_streams=$streams ||
+			error "set read_ahead_streams=$streams failed"
+		cancel_lru_locks osc
+		$LCTL set_param -n llite.*.read_ahead_stats=0
+
+		$MULTIOP $DIR/$tfile $cmd || error "interleaved reads failed"
+
+		$LCTL get_param -n llite.*.read_ahead_stats
+		misses[$streams]=$($LCTL get_param -n llite.*.read_ahead_stats |
+				   get_named_value 'misses' | calc_total)
+	done
+
+	(( ${misses[4]} < ${misses[1]} )) ||
+		error "misses ${misses[4]} with 4 streams, ${misses[1]} with 1"
+	rm -f $DIR/$tfile
+}
+run_test 101l "readahead streams for interleaved reads of one fd"
+
+test_101m() {
+	$LCTL get_param -n llite.*.read_ahead_async_stats &> /dev/null ||
+		skip "no read_ahead_async_stats support"
+	which taskset &> /dev/null || skip_env "no taskset"
+
+	local threshold=$($LCTL get_param -n \
+			  llite.*.read_ahead_async_file_threshold_mb |
+			  head -n 1)
+	local active=$($LCTL get_param -n \
+		       llite.*.max_read_ahead_async_active | head -n 1)
+	local ncpts=$($LCTL get_param -n cpu_partition_table 2>/dev/null |
+		      wc -l)
+	# partition of CPU 0, which the readers run on
+	local cpt=$($LCTL get_param -n cpu_partition_table 2>/dev/null |
+		    awk -F: '{ n = split($2, cpus, " ");
+			for (i = 1; i <= n; i++)
+				if (cpus[i] == 0) print $1 + 0 }' | head -n 1)
+	local i
+
+	[[ -n "$cpt" ]] || cpt=0
+	stack_trap "$LCTL set_param -n \
+		llite.*.read_ahead_async_file_threshold_mb=$threshold"
+	stack_trap "$LCTL set_param -n \
+		llite.*.max_read_ahead_async_active=$active"
+	$LCTL set_param -n llite.*.read_ahead_async_file_threshold_mb=1
+	# one work in flight per partition, the next ones are redirected
+	$LCTL set_param -n llite.*.max_read_ahead_async_active=1
+
+	test_mkdir $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir || error "setstripe failed"
+	for ((i = 0; i < 4; i++)); do
+		dd if=/dev/zero of=$DIR/$tdir/$tfile.$i bs=1M count=64 ||
+			error "dd $tfile.$i failed"
+	done
+	cancel_lru_locks osc
+	$LCTL set_param -n llite.*.read_ahead_async_stats=0
+	$LCTL set_param -n llite.*.read_ahead_stats=0
+
+	# concurrent large sequential reads from one CPU
+	for ((i = 0; i < 4; i++)); do
+		taskset -c 0 dd if=$DIR/$tdir/$tfile.$i of=/dev/null bs=1M &
+	done
+	wait
+	$LCTL get_param llite.*.read_ahead_async_stats
+
+	local async=$($LCTL get_param -n llite.*.read_ahead_stats |
+		      get_named_value 'async_readahead' | calc_total)
+	local queued=$($LCTL get_param -n llite.*.read_ahead_async_stats |
+		       awk -v cpt=$cpt '$1 == cpt && NF == 4 { sum += $3 }
+				      END { print sum + 0 }')
+	local redirected=$($LCTL get_param -n llite.*.read_ahead_async_stats |
+			   awk '/^[0-9]+ / { sum += $4 } END { print sum + 0 }')
+	local cpts=$($LCTL get_param -n llite.*.read_ahead_async_stats |
+		     awk '/^[0-9]+ / && $3 > 0 { print $1 }' | sort -u |
+		     wc -l)
+
+	(( async > 0 )) || error "no async readahead for sequential reads"
+	(( queued > 0 )) || error "no async readahead queued on cpt $cpt"
+	(( redirected == 0 || cpts > 1 )) ||
+		error "$redirected works redirected, queued on $cpts cpts"
+	echo "$async async readahead, $queued queued on cpt $cpt," \
+	     "$redirected redirected, $cpts of $ncpts cpts used"
+	rm -rf $DIR/$tdir
+}
+run_test 101m "async readahead queues per CPU partition"
+
 setup_test102() {
 	test_mkdir $DIR/$tdir
 	chown $RUNAS_ID $DIR/$tdir
@@ -12711,6 +12959,97 @@ test_118n()
 }
 run_test 118n "statfs() sends OST_STATFS requests in parallel"
 
+test_118o()
+{
+	local osc=$($LCTL list_param osc.$FSNAME-OST0000-osc-[^mM]* |
+		    head -n 1)
+	local rif
+
+	$LCTL get_param -n $osc.max_rpcs_in_flight_auto > /dev/null ||
+		skip "no adaptive RPCs in flight support"
+
+	save_lustre_params client "$osc.max_rpcs_in_flight" > $TMP/$tfile.save
+	save_lustre_params client "$osc.min_rpcs_in_flight" >> $TMP/$tfile.save
+	save_lustre_params client "$osc.max_rpcs_in_flight_auto" \
+		>> $TMP/$tfile.save
+	stack_trap "rm -f $TMP/$tfile.save"
+	stack_trap "restore_lustre_params < $TMP/$tfile.save"
+
+	$LCTL set_param $osc.max_rpcs_in_flight=8
+	$LCTL set_param $osc.min_rpcs_in_flight=2
+	# start from max_rpcs_in_flight with fresh statistics
+	$LCTL set_param $osc.max_rpcs_in_flight_auto=0
+	$LCTL set_param $osc.max_rpcs_in_flight_auto=1
+	$LCTL set_param $osc.min_rpcs_in_flight=9 &&
+		error "min_rpcs_in_flight above max_rpcs_in_flight accepted"
+
+	local decreases
+	local increases
+
+	$LFS setstripe -c 1 -i 0 $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile"
+	# full RPCs at normal speed set the baseline service time
+	dd if=/dev/zero of=$DIR/$tfile bs=4M count=16 conv=fsync ||
+		error "dd to $DIR/$tfile failed"
+	decreases=$($LCTL get_param -n $osc.rif_auto_stats |
+		    awk '/^decreases:/ { print $2 }')
+
+	# RPCs queued on the OST must shrink the limit
+	#define OBD_FAIL_OST_BRW_PAUSE_PACK	0x224
+	do_facet ost1 $LCTL set_param fail_val=1 fail_loc=0x224
+	stack_trap "do_facet ost1 $LCTL set_param fail_loc=0 fail_val=0"
+	dd if=/dev/zero of=$DIR/$tfile bs=4M count=4 conv=fsync,notrunc ||
+		error "dd to $DIR/$tfile with slow OST failed"
+	do_facet ost1 $LCTL set_param fail_loc=0 fail_val=0
+	$LCTL get_param $osc.rif_auto_stats
+	(( $($LCTL get_param -n $osc.rif_auto_stats |
+	     awk '/^decreases:/ { print $2 }') > decreases )) ||
+		error "RPCs in flight limit not lowered for a slow OST"
+	rif=$($LCTL get_param -n $osc.rif_auto_stats |
+	      awk '/^rpcs_in_flight:/ { print $2 }')
+	(( rif < 8 )) || error "RPCs in flight limit $rif not lowered"
+
+	# and grow back once the OST keeps up, when the window is used up
+	increases=$($LCTL get_param -n $osc.rif_auto_stats |
+		    awk '/^increases:/ { print $2 }')
+	dd if=/dev/zero of=$DIR/$tfile bs=4M count=128 conv=fsync ||
+		error "dd to $DIR/$tfile failed"
+	cancel_lru_locks osc
+	dd if=$DIR/$tfile of=/dev/null bs=4M || error "dd from $DIR/$tfile failed"
+	$LCTL get_param $osc.rif_auto_stats
+	(( $($LCTL get_param -n $osc.rif_auto_stats |
+	     awk '/^increases:/ { print $2 }') > increases )) ||
+		error "RPCs in flight limit not raised for a fast OST"
+
+	rif=$($LCTL get_param -n $osc.rif_auto_stats |
+	      awk '/^rpcs_in_flight:/ { print $2 }')
+	(( rif >= 2 && rif <= 8 )) ||
+		error "RPCs in flight limit $rif out of [2, 8]"
+}
+run_test 118o "adaptive RPCs in flight stays within admin bounds"
+
+test_118p()
+{
+	local size
+	local bad
+
+	$LFS setstripe -c 1 -i 0 $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile"
+
+	# each thread writes its own 16MiB of the same OST object
+	shared_write_scale -b 64 -s 16 -t 8 $DIR/$tfile ||
+		error "shared_write_scale failed"
+
+	size=$(stat -c %s $DIR/$tfile)
+	(( size == 8 * 16 * 1048576 )) || error "wrong file size $size"
+	cancel_lru_locks osc
+	# the 8th writer fills its region with 'h'
+	bad=$(dd if=$DIR/$tfile bs=1M skip=$((7 * 16)) count=16 2>/dev/null |
+	      tr -d h | wc -c)
+	(( bad == 0 )) || error "$bad bytes of the last writer wrong"
+}
+run_test 118p "concurrent writes of one object to disjoint regions"
+
 test_119a() # bug 11737
 {
         BSIZE=$((512 * 1024))
@@ -13216,6 +13555,154 @@ test_123c() {
 }
 run_test 123c "Can not initialize inode warning on DNE statahead"
 
+test_123e() {
+	local num=100
+	local before
+	local after
+
+	$LCTL get_param -n llite.*.statahead_fname > /dev/null ||
+		skip "no statahead_fname support"
+
+	stack_trap "$LCTL set_param llite.*.statahead_fname=0"
+	$LCTL set_param llite.*.statahead_fname=1
+
+	test_mkdir $DIR/$tdir
+	createmany -o $DIR/$tdir/out.%06d $num ||
+		error "create $num files in $DIR/$tdir failed"
+
+	cancel_lru_locks mdc
+	before=$($LCTL get_param -n llite.*.statahead_stats |
+		awk '/statahead total:/ { sum += $3 } END { print sum }')
+	# a single process stats the names in order without readdir
+	stat -c "%n %s" $(seq -f "$DIR/$tdir/out.%06g" 0 $((num - 1))) |
+		wc -l
+	after=$($LCTL get_param -n llite.*.statahead_stats |
+		awk '/statahead total:/ { sum += $3 } END { print sum }')
+	$LCTL get_param -n llite.*.statahead_stats
+
+	(( after > before )) ||
+		error "statahead not started for names in order: $before/$after"
+}
+run_test 123e "statahead for names with a numeric suffix"
+
+test_123f() {
+	local num=100
+	local leases
+	local hits
+
+	$LCTL get_param -n llite.*.dir_lease > /dev/null ||
+		skip "no dir_lease support"
+
+	stack_trap "$LCTL set_param llite.*.dir_lease=0"
+	$LCTL set_param llite.*.dir_lease=1
+
+	test_mkdir -c 1 $DIR/$tdir
+	createmany -o $DIR/$tdir/f $num ||
+		error "create $num files in $DIR/$tdir failed"
+
+	# without dir_lease, nothing is accounted
+	$LCTL set_param llite.*.dir_lease=0
+	cancel_lru_locks mdc
+	$LCTL set_param -n llite.*.dir_lease_stats=0
+	ls $DIR/$tdir > /dev/null || error "ls $DIR/$tdir failed"
+	for ((i = 0; i < num; i++)); do
+		stat $DIR/$tdir/nolease.$i &> /dev/null &&
+			error "nolease.$i should not exist"
+	done
+	$LCTL get_param -n llite.*.dir_lease_stats
+	hits=$($LCTL get_param -n llite.*.dir_lease_stats |
+	       awk '/negative (hits|misses):/ { sum += $3 } END { print sum }')
+	(( hits == 0 )) || error "$hits lookups accounted without dir_lease"
+
+	# only the directory pages in the page cache are scanned
+	$LCTL set_param llite.*.dir_lease=1
+	cancel_lru_locks mdc
+	$LCTL set_param -n llite.*.dir_lease_stats=0
+	ls $DIR/$tdir > /dev/null || error "ls $DIR/$tdir failed"
+	for ((i = 0; i < num; i++)); do
+		stat $DIR/$tdir/nonexist.$i &> /dev/null &&
+			error "nonexist.$i should not exist"
+	done
+	$LCTL get_param -n llite.*.dir_lease_stats
+	hits=$($LCTL get_param -n llite.*.dir_lease_stats |
+	       awk '/negative hits:/ { sum += $3 } END { print sum }')
+	(( hits > num / 2 )) ||
+		error "only $hits of $num negative lookups answered locally"
+
+	# a miss doesn't wait for the directory lock, it is taken once in the
+	# background, and only lookups sent under it are cached
+	cancel_lru_locks mdc
+	$LCTL set_param -n llite.*.dir_lease_stats=0
+	for ((i = 0; i < num; i++)); do
+		stat $DIR/$tdir/miss.$i &> /dev/null &&
+			error "miss.$i should not exist"
+	done
+	for ((i = 0; i < num; i++)); do
+		stat $DIR/$tdir/miss.$i &> /dev/null &&
+			error "miss.$i should not exist"
+	done
+	$LCTL get_param -n llite.*.dir_lease_stats
+	leases=$($LCTL get_param -n llite.*.dir_lease_stats |
+		 awk '/dir leases:/ { sum += $3 } END { print sum }')
+	(( leases > 0 && leases < 5 )) ||
+		error "$leases directory locks taken for $num misses"
+	hits=$($LCTL get_param -n llite.*.dir_lease_stats |
+	       awk '/negative hits:/ { sum += $3 } END { print sum }')
+	(( hits > num / 2 )) ||
+		error "only $hits of $num cached misses answered locally"
+
+	# creating a name looked up before must revoke the cached lookups
+	touch $DIR/$tdir/nonexist.0 || error "touch nonexist.0 failed"
+	stat $DIR/$tdir/nonexist.0 || error "nonexist.0 not found"
+	$MULTIOP $DIR/$tdir/nonexist.1 Oc || error "create nonexist.1 failed"
+	$CHECKSTAT -t file $DIR/$tdir/nonexist.1 ||
+		error "nonexist.1 not found"
+}
+run_test 123f "negative lookups answered under a directory lock"
+
+test_123g() {
+	local num=5000
+	local count
+	local rpcs
+
+	$LCTL get_param -n llite.*.readdir_prefetch_pages > /dev/null ||
+		skip "no readdir_prefetch_pages support"
+
+	local old=$($LCTL get_param -n llite.*.readdir_prefetch_pages |
+		    head -n 1)
+
+	stack_trap "$LCTL set_param llite.*.readdir_prefetch_pages=$old"
+	$LCTL set_param llite.*.readdir_prefetch_pages=256
+
+	test_mkdir -c $MDSCOUNT -H all_char $DIR/$tdir
+	createmany -m $DIR/$tdir/f $num ||
+		error "create $num files in $DIR/$tdir failed"
+
+	cancel_lru_locks mdc
+	$LCTL set_param llite.*.stats=clear mdc.*.stats=clear
+	count=$(ls -f $DIR/$tdir | wc -l)
+	# "." and ".." are listed too
+	(( count == num + 2 )) || error "listed $count entries, expect $num"
+	rpcs=$(calc_stats llite.*.stats readdir_prefetch)
+	(( rpcs > 0 )) || error "readdir was not prefetched"
+	rpcs=$(calc_stats mdc.*.stats mds_readpage)
+
+	# the directory must be listed in full with prefetch disabled too
+	$LCTL set_param llite.*.readdir_prefetch_pages=0
+	cancel_lru_locks mdc
+	$LCTL set_param mdc.*.stats=clear
+	count=$(ls -f $DIR/$tdir | wc -l)
+	(( count == num + 2 )) || error "listed $count entries, expect $num"
+
+	# and prefetch must not read pages readdir reads itself
+	local rpcs_off=$(calc_stats mdc.*.stats mds_readpage)
+
+	echo "READPAGE RPCs: $rpcs with prefetch, $rpcs_off without"
+	(( rpcs <= rpcs_off + MDSCOUNT )) ||
+		error "prefetch sent $rpcs READPAGE RPCs, readdir $rpcs_off"
+}
+run_test 123g "readdir prefetch of plain and striped directories"
+
 test_124a() {
 	[ $PARALLEL == "yes" ] && skip "skip parallel run"
 	$LCTL get_param -n mdc.*.connect_flags | grep -q lru_resize ||
@@ -14610,6 +15097,67 @@ test_133h() {
 }
 run_test 133h "Proc files should end with newlines"
 
+test_133i() {
+	$LCTL get_param -n llite.*.site | grep -q page_memory ||
+		skip "client built without --enable-pgstate-track"
+
+	local pages
+	local cached
+	local per_gb
+
+	$LFS setstripe -c 1 $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile"
+	cancel_lru_locks osc
+	dd if=/dev/zero of=$DIR/$tfile bs=1M count=16 || error "dd failed"
+
+	cached=$($LCTL get_param -n llite.*.site | awk '/page_memory/ {
+		print $2 }' | head -n1)
+	per_gb=$($LCTL get_param -n llite.*.site | awk '/page_memory/ {
+		print $6 }' | head -n1)
+	$LCTL get_param llite.*.site | grep page_memory
+	(( cached >= 16 * 1024 * 1024 / PAGE_SIZE )) ||
+		error "$cached pages accounted for 16MiB of cached data"
+	(( per_gb > 0 )) || error "no cl_page memory per cached GiB"
+
+	cancel_lru_locks osc
+	pages=$($LCTL get_param -n llite.*.site | awk '/page_memory/ {
+		print $2 }' | head -n1)
+	(( pages < cached )) ||
+		error "cl_page memory not released: $cached -> $pages pages"
+}
+run_test 133i "cl_page memory is reported per cached GiB"
+
+test_133j() {
+	$LCTL list_param llite.*.io_stage_latency > /dev/null 2>&1 ||
+		skip "client does not have io_stage_latency"
+
+	local stage
+	local col=2
+	local ios
+
+	$LCTL set_param llite.*.io_stage_latency=clear
+	dd if=/dev/zero of=$DIR/$tfile bs=1M count=4 || error "dd write failed"
+	stack_trap "rm -f $DIR/$tfile"
+	cancel_lru_locks osc
+	dd if=$DIR/$tfile of=/dev/null bs=1M || error "dd read failed"
+
+	$LCTL get_param llite.*.io_stage_latency
+	for stage in iter_init lock start end; do
+		ios=$($LCTL get_param -n llite.*.io_stage_latency |
+		      awk -v col=$col 'NR > 1 { sum += $col } END { print sum }')
+		(( ios > 0 )) || error "no IO accounted for stage $stage"
+		col=$((col + 1))
+	done
+
+	# only reads and writes are accounted
+	$LCTL set_param llite.*.io_stage_latency=clear
+	$TRUNCATE $DIR/$tfile 0 || error "truncate failed"
+	ios=$($LCTL get_param -n llite.*.io_stage_latency |
+	      awk 'NR > 1 { sum += $2 + $3 + $4 + $5 } END { print sum }')
+	(( ios == 0 )) || error "$ios IOs accounted after clear and truncate"
+}
+run_test 133j "cl_io stage latency histograms"
+
 test_134a() {
 	remote_mds_nodsh && skip "remote MDS with nodsh"
 	[[ $MDS1_VERSION -lt $(version_code 2.7.54) ]] &&
@@ -21527,6 +22075,46 @@ test_248b() {
 }
 run_test 248b "test short_io read and write for both small and large sizes"
 
+test_248c() {
+	$LCTL get_param -n llite.*.fault_around > /dev/null ||
+		skip "no fault_around support"
+
+	local fast_read=$($LCTL get_param -n llite.*.fast_read | head -n 1)
+	local around=$($LCTL get_param -n llite.*.fault_around | head -n 1)
+	local faults
+
+	stack_trap "$LCTL set_param llite.*.fast_read=$fast_read" EXIT
+	stack_trap "$LCTL set_param llite.*.fault_around=$around" EXIT
+	$LCTL set_param llite.*.fast_read=1
+
+	dd if=/dev/urandom of=$TMP/$tfile bs=1M count=16 ||
+		error "dd to $TMP/$tfile failed"
+	stack_trap "rm -f $TMP/$tfile" EXIT
+	cp $TMP/$tfile $DIR/$tfile || error "cp to $DIR/$tfile failed"
+
+	# pages are cached under the write lock, map them around the fault
+	$LCTL set_param llite.*.fault_around=1
+	$LCTL set_param llite.*.stats=clear
+	$MMAP_CAT $DIR/$tfile | cmp - $TMP/$tfile ||
+		error "mmap data mismatch with fault_around"
+	$LCTL get_param llite.*.stats | grep page_fault
+	faults=$(calc_stats llite.*.stats page_fault_around)
+	(( faults > 0 )) || error "no fault around with cached pages"
+
+	# uncached pages must still be read through ->fault()
+	cancel_lru_locks osc
+	$MMAP_CAT $DIR/$tfile | cmp - $TMP/$tfile ||
+		error "mmap data mismatch after lock cancel"
+
+	$LCTL set_param llite.*.fault_around=0
+	$LCTL set_param llite.*.stats=clear
+	$MMAP_CAT $DIR/$tfile | cmp - $TMP/$tfile ||
+		error "mmap data mismatch without fault_around"
+	faults=$(calc_stats llite.*.stats page_fault_around)
+	(( faults == 0 )) || error "$faults fault around when disabled"
+}
+run_test 248c "mmap fault-around of cached pages"
+
 test_249() { # LU-7890
 	[ $MDS1_VERSION -lt $(version_code 2.8.53) ] &&
 		skip "Need at least version 2.8.54"
@@ -22079,6 +22667,107 @@ test_255c() {
 }
 run_test 255c "suite of ladvise lockahead tests"
 
+test_255d() {
+	[ $OST1_VERSION -lt $(version_code 2.10.50) ] &&
+		skip "lustre < 2.10.50 does not support lockahead"
+	$LCTL list_param llite.*.write_lockahead_count > /dev/null 2>&1 ||
+		skip "client does not support write lockahead"
+
+	local saved=$($LCTL get_param -n llite.*.write_lockahead_count |
+		      head -n1)
+	local samples
+	local i
+
+	$LCTL set_param llite.*.write_lockahead_count=4
+	stack_trap "$LCTL set_param llite.*.write_lockahead_count=$saved"
+
+	$LFS setstripe -i 0 -c 1 $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile"
+	cancel_lru_locks osc
+
+	# every 4th 64KiB block, as one of 4 interleaved writers would do
+	$LCTL set_param llite.*.stats=0
+	$MULTIOP $DIR/$tfile oO_WRONLY:$(for i in {0..7}; do
+		echo -n "z$((i * 262144))w65536"; done)c ||
+		error "strided write failed"
+	samples=$(calc_stats llite.*.stats write_lockahead)
+	(( samples > 0 )) || error "no lock requested ahead of strided writes"
+
+	# sequential writes are not strided
+	cancel_lru_locks osc
+	$LCTL set_param llite.*.stats=0
+	dd if=/dev/zero of=$DIR/$tfile bs=64k count=8 conv=notrunc ||
+		error "dd write failed"
+	samples=$(calc_stats llite.*.stats write_lockahead)
+	(( samples == 0 )) || error "lock requested ahead of sequential writes"
+}
+run_test 255d "lockahead of strided writes"
+
+test_255e() {
+	[ $OST1_VERSION -lt $(version_code 2.10.50) ] &&
+		skip "lustre < 2.10.50 does not support lockahead"
+	$LCTL list_param llite.*.io_lock_prefetch_bytes > /dev/null 2>&1 ||
+		skip "client does not support IO lock prefetch"
+
+	local saved=$($LCTL get_param -n llite.*.io_lock_prefetch_bytes |
+		      head -n1)
+	local samples
+
+	$LCTL set_param llite.*.io_lock_prefetch_bytes=4M
+	stack_trap "$LCTL set_param llite.*.io_lock_prefetch_bytes=$saved"
+
+	$LFS setstripe -c $OSTCOUNT -S 1M $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile $DIR/$tfile.src"
+	dd if=/dev/urandom of=$DIR/$tfile.src bs=1M count=16 ||
+		error "dd to create source file failed"
+	cancel_lru_locks osc
+
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=16M || error "dd write failed"
+	cancel_lru_locks osc
+	cmp $DIR/$tfile.src $DIR/$tfile || error "data wrong after write"
+	samples=$(calc_stats llite.*.stats io_lock_prefetch)
+	(( samples > 0 )) || error "no stripe locks prefetched for large IO"
+
+	# IOs below the threshold go stripe by stripe
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile of=/dev/null bs=1M || error "dd read failed"
+	samples=$(calc_stats llite.*.stats io_lock_prefetch)
+	(( samples == 0 )) || error "stripe locks prefetched for small IO"
+
+	# the locks of a sequential writer cover its next IOs, so each stripe
+	# is enqueued about once, not once per IO
+	local stripes=$($LFS getstripe -c $DIR/$tfile)
+	local count=16
+	local enqueues
+
+	cancel_lru_locks osc
+	$LCTL set_param osc.*.stats=clear
+	dd if=/dev/zero of=$DIR/$tfile bs=4M count=$count conv=notrunc ||
+		error "dd sequential write failed"
+	enqueues=$(calc_stats osc.*.stats ldlm_enqueue)
+	echo "$enqueues lock enqueues for $count writes on $stripes stripes"
+	(( enqueues <= 2 * stripes )) ||
+		error "$enqueues lock enqueues for $count sequential writes"
+
+	# and readahead is not stopped at the end of each IO
+	cancel_lru_locks osc
+	$LCTL set_param osc.*.stats=clear
+	$LCTL set_param -n llite.*.read_ahead_stats=0
+	dd if=$DIR/$tfile of=/dev/null bs=4M count=$count ||
+		error "dd sequential read failed"
+	enqueues=$(calc_stats osc.*.stats ldlm_enqueue)
+	echo "$enqueues lock enqueues for $count reads on $stripes stripes"
+	(( enqueues <= 2 * stripes )) ||
+		error "$enqueues lock enqueues for $count sequential reads"
+	$LCTL get_param llite.*.read_ahead_stats
+	local miss=$($LCTL get_param -n llite.*.read_ahead_stats |
+		     get_named_value 'misses' | calc_total)
+	(( miss < count )) ||
+		error "$miss readahead misses for $count sequential reads"
+}
+run_test 255e "lock all stripes of a large IO at once"
+
 test_256() {
 	[ $PARALLEL == "yes" ] && skip "skip parallel run"
 	remote_mds_nodsh && skip "remote MDS with nodsh"
@@ -23257,6 +23946,75 @@ test_278() {
 }
 run_test 278 "Race starting MDS between MDTs stop/start"
 
+test_279() {
+	[ $PARALLEL == "yes" ] && skip "skip parallel run"
+
+	local param="osc.$FSNAME-OST0000-osc-[^M]*.osc_cached_mb"
+
+	$LCTL get_param -n $param | grep -q "^cpt0_lru_mb:" ||
+		skip "no per-CPT LRU lists"
+
+	local ncpts=$($LCTL get_param -n cpu_partition_table 2>/dev/null |
+		      wc -l)
+	local cpt
+	local cpu
+
+	(( ncpts > 0 )) || ncpts=1
+	test_mkdir $DIR/$tdir
+	$LFS setstripe -c 1 -i 0 $DIR/$tdir || error "setstripe failed"
+	cancel_lru_locks osc
+
+	# write from a CPU of each partition, so that pages are allocated
+	# from the memory of different partitions where the node has any
+	for ((cpt = 0; cpt < ncpts; cpt++)); do
+		cpu=$($LCTL get_param -n cpu_partition_table 2>/dev/null |
+		      awk -F: -v cpt=$cpt '$1 == cpt { print $2 }' |
+		      awk '{ print $1 }')
+		if [[ -n "$cpu" ]] && which taskset &> /dev/null; then
+			taskset -c $cpu dd if=/dev/zero bs=1M count=16 \
+				of=$DIR/$tdir/$tfile.$cpt ||
+				error "write from cpu $cpu failed"
+		else
+			dd if=/dev/zero of=$DIR/$tdir/$tfile.$cpt bs=1M \
+				count=16 || error "write $tfile.$cpt failed"
+		fi
+	done
+	sync
+	$LCTL get_param $param
+
+	local used=$($LCTL get_param -n $param | awk '/^used_mb:/ { print $2 }')
+	local busy=$($LCTL get_param -n $param |
+		     awk '/^busy_cnt:/ { print $2 }')
+	local sum=$($LCTL get_param -n $param |
+		    awk '/^cpt[0-9]+_lru_mb:/ { sum += $2 }
+			 END { print sum + 0 }')
+	local parts=$($LCTL get_param -n $param |
+		      awk '/^cpt[0-9]+_lru_mb:/ && $2 > 0 { n++ }
+			   END { print n + 0 }')
+
+	(( busy == 0 )) || error "$busy pages still busy after sync"
+	(( used >= ncpts * 16 )) ||
+		error "used_mb $used < $((ncpts * 16)) written"
+	# each partition count is rounded down to MiB on its own
+	(( sum <= used && sum > used - ncpts )) ||
+		error "partitions hold $sum MiB, LRU holds $used MiB"
+	(( parts > 0 )) || error "no partition holds LRU pages"
+	echo "$parts of $ncpts partitions hold LRU pages"
+
+	# shrink runs on one CPU, it must drain the other partitions as well
+	$LCTL set_param $param=0
+	$LCTL get_param $param
+
+	used=$($LCTL get_param -n $param | awk '/^used_mb:/ { print $2 }')
+	sum=$($LCTL get_param -n $param |
+	      awk '/^cpt[0-9]+_lru_mb:/ { sum += $2 } END { print sum + 0 }')
+	(( used == 0 )) || error "used_mb $used after shrink"
+	(( sum == 0 )) || error "partitions hold $sum MiB after shrink"
+
+	rm -rf $DIR/$tdir
+}
+run_test 279 "per-CPT LRU page counts and shrink across partitions"
+
 test_280() {
 	[ $MGS_VERSION -lt $(version_code 2.13.52) ] &&
 		skip "Need MGS version at least 2.13.52"
@@ -24674,6 +25432,10 @@ test_398d() { #  LU-13846
 	diff $DIR/$tfile $aio_file || error "file diff after aiocp"
 
 	# make sure we don't crash and fail properly
+	if $LCTL list_param llite.*.unaligned_dio > /dev/null 2>&1; then
+		$LCTL set_param llite.*.unaligned_dio=0
+		stack_trap "$LCTL set_param llite.*.unaligned_dio=1"
+	fi
 	aiocp -a 512 -b 64M -s 64M -f O_DIRECT $DIR/$tfile $aio_file &&
 		error "aio not aligned with PAGE SIZE should fail"
 
@@ -24978,6 +25740,129 @@ test_398n() { #  LU-13798
 }
 run_test 398n "test append with parallel DIO"
 
+test_398o() {
+	$LCTL list_param llite.*.unaligned_dio > /dev/null 2>&1 ||
+		skip "client does not support unaligned DIO"
+
+	local bs=$((7 * 512))
+
+	$LFS setstripe -c 2 -S 1M $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile $DIR/$tfile.*"
+
+	dd if=/dev/urandom of=$DIR/$tfile.src bs=1M count=4 ||
+		error "dd to create source file failed"
+
+	# $bs is not a multiple of PAGE_SIZE, so every write after the
+	# first one starts at an unaligned file offset
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=$bs oflag=direct ||
+		error "unaligned dio write failed"
+	cancel_lru_locks osc
+	cmp $DIR/$tfile.src $DIR/$tfile || error "data wrong after write"
+
+	dd if=$DIR/$tfile of=$DIR/$tfile.2 bs=$bs iflag=direct ||
+		error "unaligned dio read failed"
+	cmp $DIR/$tfile.src $DIR/$tfile.2 || error "data wrong after read"
+
+	$LCTL set_param llite.*.unaligned_dio=0
+	stack_trap "$LCTL set_param llite.*.unaligned_dio=1"
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=512 count=1 seek=1 \
+		oflag=direct conv=notrunc &&
+		error "unaligned dio succeeded with unaligned_dio=0"
+	return 0
+}
+run_test 398o "unaligned DIO through bounce pages"
+
+test_398p() {
+	$LCTL list_param llite.*.hybrid_io > /dev/null 2>&1 ||
+		skip "client does not support hybrid I/O"
+
+	local saved=$($LCTL get_param -n llite.*.hybrid_io | head -n1)
+	local write_threshold=$($LCTL get_param -n \
+				llite.*.hybrid_io_write_threshold_bytes |
+				head -n1)
+	local read_threshold=$($LCTL get_param -n \
+			       llite.*.hybrid_io_read_threshold_bytes |
+			       head -n1)
+	local lru_pct=$($LCTL get_param -n llite.*.hybrid_io_lru_pct | head -n1)
+	local samples
+
+	$LCTL set_param llite.*.hybrid_io=1 \
+		llite.*.hybrid_io_write_threshold_bytes=1048576 \
+		llite.*.hybrid_io_read_threshold_bytes=1048576 \
+		llite.*.hybrid_io_lru_pct=100
+	stack_trap "$LCTL set_param llite.*.hybrid_io=$saved \
+		llite.*.hybrid_io_write_threshold_bytes=$write_threshold \
+		llite.*.hybrid_io_read_threshold_bytes=$read_threshold \
+		llite.*.hybrid_io_lru_pct=$lru_pct"
+
+	$LFS setstripe -c 2 -S 1M $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile $DIR/$tfile.*"
+	dd if=/dev/urandom of=$DIR/$tfile.src bs=1M count=8 ||
+		error "dd to create source file failed"
+
+	# small writes stay in the page cache
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=64k || error "dd write failed"
+	samples=$(calc_stats llite.*.stats hybrid_write_bytes)
+	(( samples == 0 )) || error "small writes were switched to DIO"
+
+	# large writes bypass it, except the unaligned tail
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=$((4 << 20 | 4000)) \
+		conv=notrunc || error "dd write failed"
+	samples=$(calc_stats llite.*.stats hybrid_write_bytes)
+	(( samples > 0 )) || error "large writes were not switched to DIO"
+	cancel_lru_locks osc
+	cmp $DIR/$tfile.src $DIR/$tfile || error "data wrong after write"
+
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile of=$DIR/$tfile.2 bs=4M || error "dd read failed"
+	samples=$(calc_stats llite.*.stats hybrid_read_bytes)
+	(( samples > 0 )) || error "large reads were not switched to DIO"
+	cmp $DIR/$tfile.src $DIR/$tfile.2 || error "data wrong after read"
+}
+run_test 398p "hybrid buffered/direct I/O switch"
+
+test_398q() {
+	$LCTL list_param llite.*.zerocopy_write > /dev/null 2>&1 ||
+		skip "client does not support zero-copy write"
+
+	local saved=$($LCTL get_param -n llite.*.zerocopy_write | head -n1)
+	local threshold=$($LCTL get_param -n \
+			  llite.*.hybrid_io_write_threshold_bytes | head -n1)
+	local samples
+
+	$LCTL set_param llite.*.zerocopy_write=1 \
+		llite.*.hybrid_io_write_threshold_bytes=1048576
+	stack_trap "$LCTL set_param llite.*.zerocopy_write=$saved \
+		llite.*.hybrid_io_write_threshold_bytes=$threshold"
+
+	$LFS setstripe -c 2 -S 1M $DIR/$tfile
+	stack_trap "rm -f $DIR/$tfile $DIR/$tfile.*"
+	dd if=/dev/urandom of=$DIR/$tfile.src bs=1M count=8 ||
+		error "dd to create source file failed"
+	cancel_lru_locks osc
+
+	# large writes of uncached data pin the user pages
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=4M || error "dd write failed"
+	samples=$(calc_stats llite.*.stats zerocopy_write_bytes)
+	(( samples > 0 )) || error "uncached writes were not zero-copy"
+	cancel_lru_locks osc
+	cmp $DIR/$tfile.src $DIR/$tfile || error "data wrong after write"
+
+	# data just read is expected to be read again, keep it cached
+	cat $DIR/$tfile > /dev/null
+	$LCTL set_param llite.*.stats=0
+	dd if=$DIR/$tfile.src of=$DIR/$tfile bs=4M conv=notrunc ||
+		error "dd rewrite failed"
+	samples=$(calc_stats llite.*.stats zerocopy_write_bytes)
+	(( samples == 0 )) || error "writes over cached pages were zero-copy"
+	cancel_lru_locks osc
+	cmp $DIR/$tfile.src $DIR/$tfile || error "data wrong after rewrite"
+}
+run_test 398q "zero-copy write of uncached data"
+
 test_fake_rw() {
 	local read_write=$1
 	if [ "$read_write" = "write" ]; then
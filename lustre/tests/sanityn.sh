@@ -3700,6 +3700,66 @@ test_73() {
 }
 run_test 73 "getxattr should not cause xattr lock cancellation"
 
+test_73b() {
+	(( $MDS1_VERSION >= $(version_code 2.15.6) )) ||
+		skip "Need MDS version at least 2.15.6"
+	# only osd-ldiskfs keeps a version of the xattrs of an object
+	[ "$mds1_FSTYPE" = ldiskfs ] || skip "ldiskfs only test"
+
+	local p="$TMP/sanityN-$TESTNAME.parameters"
+	local count
+
+	save_lustre_params client "llite.*.xattr_cache" > $p
+	stack_trap "restore_lustre_params < $p; rm -f $p"
+	lctl set_param llite.*.xattr_cache 1 ||
+		skip "xattr cache is not supported"
+
+	touch $DIR1/$tfile
+	setfattr -n user.attr1 -v value1 $DIR1/$tfile ||
+		error "setfattr1 failed"
+	setfattr -n user.attr2 -v value2 $DIR1/$tfile ||
+		error "setfattr2 failed"
+	getfattr -d $DIR2/$tfile | grep value1 || error "getfattr1 failed"
+
+	# cached xattrs survive lock cancellation and are only revalidated
+	cancel_lru_locks mdc
+	clear_stats llite.*.stats
+	getfattr -d $DIR2/$tfile | grep value2 || error "getfattr2 failed"
+	count=$(calc_stats llite.*.stats getxattr_revalidated)
+	(( count > 0 )) || error "xattrs were fetched again after cancel"
+
+	# a modification must invalidate the version
+	setfattr -n user.attr1 -v value3 $DIR1/$tfile ||
+		error "setfattr3 failed"
+	cancel_lru_locks mdc
+	clear_stats llite.*.stats
+	getfattr -n user.attr1 $DIR2/$tfile | grep value3 ||
+		error "stale xattr after modification"
+	count=$(calc_stats llite.*.stats getxattr_revalidated)
+	(( count == 0 )) || error "modified xattrs revalidated $count times"
+
+	# so must an update of an xattr not set through setxattr
+	getfattr -d $DIR2/$tfile | grep value3 || error "getfattr4 failed"
+	$LFS hsm_set --exists $DIR1/$tfile || error "hsm_set failed"
+	cancel_lru_locks mdc
+	clear_stats llite.*.stats
+	getfattr -d $DIR2/$tfile | grep value3 || error "getfattr5 failed"
+	count=$(calc_stats llite.*.stats getxattr_revalidated)
+	(( count == 0 )) || error "xattrs revalidated $count times after HSM"
+
+	# versions from an earlier mount of the MDT never match, whatever the
+	# clock of the MDS
+	getfattr -d $DIR2/$tfile | grep value3 || error "getfattr6 failed"
+	fail mds1
+	cancel_lru_locks mdc
+	clear_stats llite.*.stats
+	getfattr -d $DIR2/$tfile | grep value3 || error "getfattr7 failed"
+	count=$(calc_stats llite.*.stats getxattr_revalidated)
+	(( count == 0 )) ||
+		error "xattrs revalidated $count times after MDT restart"
+}
+run_test 73b "xattr cache is revalidated by version after lock cancel"
+
 test_74() {
 	[ "$MDS1_VERSION" -lt $(version_code 2.4.93) ] &&
 		skip "Need MDS version at least 2.4.93"
@@ -5959,6 +6019,29 @@ test_113 () {
 }
 run_test 113 "check servers of specified fs"
 
+test_114() {
+	local num=50
+	local i
+
+	$LCTL get_param -n llite.*.dir_lease > /dev/null ||
+		skip "no dir_lease support"
+
+	stack_trap "$LCTL set_param llite.*.dir_lease=0"
+	$LCTL set_param llite.*.dir_lease=1
+
+	test_mkdir -c 1 $DIR1/$tdir
+	cancel_lru_locks mdc
+	for ((i = 0; i < num; i++)); do
+		# cache the miss on the first mount, which takes the lock
+		stat $DIR1/$tdir/f$i &> /dev/null && error "f$i should not exist"
+		stat $DIR1/$tdir/f$i &> /dev/null && error "f$i should not exist"
+		touch $DIR2/$tdir/f$i || error "touch $DIR2/$tdir/f$i failed"
+		stat $DIR1/$tdir/f$i > /dev/null ||
+			error "f$i created on $DIR2 not found on $DIR1"
+	done
+}
+run_test 114 "negative lookups cached under dir_lease see remote creates"
+
 log "cleanup: ======================================================"
 
 # kill and wait in each test only guarentee script finish, but command in script
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: GPL-2.0
+
+/*
+ * Measure how buffered writes of disjoint regions of one file scale with the
+ * number of writer threads. Each round truncates the file, then N threads
+ * each write their own contiguous region of it, and the write rate is
+ * printed. Dirty data is flushed after the timed part of a round.
+ *
+ * Usage: shared_write_scale [-b block_size] [-s region_size] [-t threads] file
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static size_t block_size = 64 << 10;
+static size_t region_size = 64 << 20;
+static int fd = -1;
+
+struct writer {
+	pthread_t	w_thread;
+	int		w_index;
+	int		w_rc;
+};
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [-b block_size] [-s region_size] [-t max_threads] file\n"
+		"  -b: size of each write in KiB (default 64)\n"
+		"  -s: size written by each thread in MiB (default 64)\n"
+		"  -t: run with 1, 2, 4, ... up to max_threads (default 8)\n",
+		prog);
+	exit(1);
+}
+
+static void *writer_start(void *arg)
+{
+	struct writer *w = arg;
+	off_t pos = (off_t)w->w_index * region_size;
+	off_t end = pos + region_size;
+	char *buf;
+
+	buf = malloc(block_size);
+	if (!buf) {
+		w->w_rc = -ENOMEM;
+		return NULL;
+	}
+	memset(buf, 'a' + w->w_index % 26, block_size);
+
+	for (; pos < end; pos += block_size) {
+		ssize_t rc = pwrite(fd, buf, block_size, pos);
+
+		if (rc != (ssize_t)block_size) {
+			w->w_rc = rc < 0 ? -errno : -EIO;
+			break;
+		}
+	}
+	free(buf);
+
+	return NULL;
+}
+
+static int run_round(int nthreads)
+{
+	struct writer *writers;
+	struct timespec start, stop;
+	double secs;
+	int rc = 0;
+	int i;
+
+	if (ftruncate(fd, 0) < 0) {
+		fprintf(stderr, "ftruncate failed: %s\n", strerror(errno));
+		return -errno;
+	}
+
+	writers = calloc(nthreads, sizeof(*writers));
+	if (!writers)
+		return -ENOMEM;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < nthreads; i++) {
+		writers[i].w_index = i;
+		rc = pthread_create(&writers[i].w_thread, NULL, writer_start,
+				    &writers[i]);
+		if (rc) {
+			fprintf(stderr, "pthread_create failed: %s\n",
+				strerror(rc));
+			nthreads = i;
+			rc = -rc;
+			break;
+		}
+	}
+	for (i = 0; i < nthreads; i++) {
+		pthread_join(writers[i].w_thread, NULL);
+		if (writers[i].w_rc && !rc) {
+			fprintf(stderr, "write of thread %d failed: %s\n",
+				i, strerror(-writers[i].w_rc));
+			rc = writers[i].w_rc;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	free(writers);
+
+	if (fsync(fd) < 0 && !rc) {
+		fprintf(stderr, "fsync failed: %s\n", strerror(errno));
+		rc = -errno;
+	}
+	if (rc)
+		return rc;
+
+	secs = stop.tv_sec - start.tv_sec +
+	       (stop.tv_nsec - start.tv_nsec) / 1e9;
+	printf("threads: %d write: %.1f MiB/s\n", nthreads,
+	       (double)nthreads * region_size / (1 << 20) / secs);
+	fflush(stdout);
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int max_threads = 8;
+	int nthreads;
+	int rc = 0;
+	int c;
+
+	while ((c = getopt(argc, argv, "b:s:t:")) != -1) {
+		switch (c) {
+		case 'b':
+			block_size = strtoul(optarg, NULL, 0) << 10;
+			break;
+		case 's':
+			region_size = strtoul(optarg, NULL, 0) << 20;
+			break;
+		case 't':
+			max_threads = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+	if (optind != argc - 1 || block_size == 0 ||
+	    region_size < block_size || max_threads < 1)
+		usage(argv[0]);
+
+	fd = open(argv[optind], O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		fprintf(stderr, "open %s failed: %s\n", argv[optind],
+			strerror(errno));
+		return 1;
+	}
+
+	for (nthreads = 1; nthreads <= max_threads && !rc; nthreads *= 2)
+		rc = run_round(nthreads);
+
+	close(fd);
+
+	return rc ? 1 : 0;
+}
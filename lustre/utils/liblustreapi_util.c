@@ -313,6 +313,24 @@ retry_open:
 	return rc ? -errno : 0;
 }
 
+/*
+ * Start statahead of the names or FIDs in @list under directory @path, for
+ * the calling process to stat them later.
+ */
+int llapi_statahead(const char *path, struct ll_statahead_list *list)
+{
+	int fd, rc;
+
+	fd = open(path, O_RDONLY | O_DIRECTORY | O_NONBLOCK);
+	if (fd < 0)
+		return -errno;
+
+	rc = ioctl(fd, LL_IOC_STATAHEAD, list);
+	close(fd);
+
+	return rc ? -errno : 0;
+}
+
 int llapi_direntry_remove(char *dname)
 {
 #ifdef LL_IOC_REMOVE_ENTRY
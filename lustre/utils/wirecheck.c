@@ -761,6 +761,7 @@ check_obdo(void)
 	CHECK_DEFINE_64X(OBD_MD_FLLAZYSIZE);
 	CHECK_DEFINE_64X(OBD_MD_FLLAZYBLOCKS);
 	CHECK_DEFINE_64X(OBD_MD_ENCCTX);
+	CHECK_DEFINE_64X(OBD_MD_FLXATTRVER);
 
 	CHECK_CVALUE_X(OBD_FL_INLINEDATA);
 	CHECK_CVALUE_X(OBD_FL_OBDMDEXISTS);